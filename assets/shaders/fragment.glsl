@@ -4,39 +4,44 @@ out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoord;
+in vec3 ObjectColor; // Per-object (or per-instance) surface color from the vertex stage
 
-uniform vec3 lightPos;
-uniform vec3 lightPos2; // Secondary light
-uniform vec3 viewPos;
-uniform vec3 lightColor;
-uniform vec3 lightColor2; // Secondary light color
-uniform vec3 objectColor;
+// Per-frame camera and lighting data, shared by every scene shader (std140, binding 0)
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;
+    vec4 lightPos;
+    vec4 lightPos2; // Secondary light
+    vec4 lightColor;
+    vec4 lightColor2; // Secondary light color
+};
 uniform sampler2D texture1;
 
 void main() {
     vec3 norm = normalize(Normal);
-    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 viewDir = normalize(viewPos.xyz - FragPos);
     vec3 result = vec3(0.0);
 
     // Primary light
     {
         // Ambient
         float ambientStrength = 0.6; // Increased for much better visibility
-        vec3 ambient = ambientStrength * lightColor;
+        vec3 ambient = ambientStrength * lightColor.xyz;
 
         // Diffuse
-        vec3 lightDir = normalize(lightPos - FragPos);
+        vec3 lightDir = normalize(lightPos.xyz - FragPos);
         float diff = max(dot(norm, lightDir), 0.0);
-        vec3 diffuse = diff * lightColor * 1.5; // Boost diffuse
+        vec3 diffuse = diff * lightColor.xyz * 1.5; // Boost diffuse
 
         // Specular
         float specularStrength = 0.5; // Moderate specular
         vec3 reflectDir = reflect(-lightDir, norm);
         float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
-        vec3 specular = specularStrength * spec * lightColor;
+        vec3 specular = specularStrength * spec * lightColor.xyz;
 
         // Attenuation
-        float distance = length(lightPos - FragPos);
+        float distance = length(lightPos.xyz - FragPos);
         float attenuation = 1.0 / (1.0 + 0.05 * distance + 0.01 * distance * distance); // Softer attenuation
         diffuse *= attenuation;
         specular *= attenuation;
@@ -48,21 +53,21 @@ void main() {
     {
         // Ambient
         float ambientStrength = 0.4;
-        vec3 ambient = ambientStrength * lightColor2;
+        vec3 ambient = ambientStrength * lightColor2.xyz;
 
         // Diffuse
-        vec3 lightDir = normalize(lightPos2 - FragPos);
+        vec3 lightDir = normalize(lightPos2.xyz - FragPos);
         float diff = max(dot(norm, lightDir), 0.0);
-        vec3 diffuse = diff * lightColor2 * 1.2;
+        vec3 diffuse = diff * lightColor2.xyz * 1.2;
 
         // Specular
         float specularStrength = 0.3;
         vec3 reflectDir = reflect(-lightDir, norm);
         float spec = pow(max(dot(viewDir, reflectDir), 0.0), 64);
-        vec3 specular = specularStrength * spec * lightColor2;
+        vec3 specular = specularStrength * spec * lightColor2.xyz;
 
         // Attenuation
-        float distance = length(lightPos2 - FragPos);
+        float distance = length(lightPos2.xyz - FragPos);
         float attenuation = 1.0 / (1.0 + 0.05 * distance + 0.01 * distance * distance);
         diffuse *= attenuation;
         specular *= attenuation;
@@ -70,7 +75,7 @@ void main() {
         result += (ambient + diffuse + specular);
     }
 
-    result *= objectColor;
+    result *= ObjectColor;
     // Handle missing texture gracefully
     vec4 texColor = vec4(1.0); // Default white if no texture
     // Uncomment below when texture is loaded:
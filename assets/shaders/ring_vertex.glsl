@@ -0,0 +1,32 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoord;
+// Per-instance attributes (one mat4 takes four attribute slots)
+layout (location = 3) in mat4 aInstanceModel;
+layout (location = 7) in vec3 aInstanceColor;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoord;
+out vec3 ObjectColor;
+
+// Per-frame camera and lighting data, shared by every scene shader (std140, binding 0)
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;
+    vec4 lightPos;
+    vec4 lightPos2;
+    vec4 lightColor;
+    vec4 lightColor2;
+};
+
+void main() {
+    FragPos = vec3(aInstanceModel * vec4(aPos, 1.0));
+    // Ring transforms are rigid, so the upper 3x3 transforms normals directly
+    Normal = mat3(aInstanceModel) * aNormal;
+    TexCoord = aTexCoord;
+    ObjectColor = aInstanceColor;
+    gl_Position = projection * view * vec4(FragPos, 1.0);
+}
@@ -6,14 +6,25 @@ layout (location = 2) in vec2 aTexCoord;
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
+out vec3 ObjectColor;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// Per-frame camera and lighting data, shared by every scene shader (std140, binding 0)
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec4 viewPos;
+    vec4 lightPos;
+    vec4 lightPos2;
+    vec4 lightColor;
+    vec4 lightColor2;
+};
+uniform vec3 objectColor;
 
 void main() {
     FragPos = vec3(model * vec4(aPos, 1.0));
     Normal = mat3(transpose(inverse(model))) * aNormal;
     TexCoord = aTexCoord;
+    ObjectColor = objectColor;
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+double elapsedNs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Value of "key": in a single-line JSON object written by writeBenchmarkJson
+const char* findJsonValue(const std::string& line, const char* key) {
+    std::string pattern = std::string("\"") + key + "\":";
+    size_t position = line.find(pattern);
+    return position == std::string::npos ? nullptr : line.c_str() + position + pattern.size();
+}
+
+}
+
+BenchmarkRunner::BenchmarkRunner(const BenchmarkOptions& options) : options(options) {}
+
+bool BenchmarkRunner::isSelected(const std::string& name, int scale) const {
+    if (scale > options.maxScale) return false;
+    return options.filter.empty() || name.find(options.filter) != std::string::npos;
+}
+
+void BenchmarkRunner::run(const std::string& name, int scale, const std::function<void()>& body,
+                          const std::function<void()>& setup) {
+    if (!isSelected(name, scale)) return;
+
+    // Calibrate the loop count from a single call so timer overhead stays negligible
+    if (setup) setup();
+    auto start = std::chrono::steady_clock::now();
+    body();
+    double singleNs = std::max(elapsedNs(start), 1.0);
+    int64_t iterations = std::max<int64_t>(1, (int64_t)std::ceil(options.minRepetitionMs * 1e6 / singleNs));
+    iterations = std::min<int64_t>(iterations, 10000000);
+
+    std::vector<double> samples;
+    samples.reserve(options.repetitions);
+    for (int repetition = 0; repetition < options.warmupRepetitions + options.repetitions; ++repetition) {
+        if (setup) setup();
+        start = std::chrono::steady_clock::now();
+        for (int64_t i = 0; i < iterations; ++i) {
+            body();
+        }
+        double sampleNs = elapsedNs(start) / iterations;
+        if (repetition >= options.warmupRepetitions) {
+            samples.push_back(sampleNs);
+        }
+    }
+    if (samples.empty()) return;
+
+    std::sort(samples.begin(), samples.end());
+    BenchmarkResult result;
+    result.name = name;
+    result.scale = scale;
+    result.repetitions = (int)samples.size();
+    result.iterationsPerRepetition = iterations;
+    result.minNs = samples.front();
+    result.maxNs = samples.back();
+    size_t middle = samples.size() / 2;
+    result.medianNs = samples.size() % 2 ? samples[middle] : 0.5 * (samples[middle - 1] + samples[middle]);
+    result.p95Ns = samples[std::min(samples.size() - 1, (size_t)std::ceil(0.95 * samples.size()) - 1)];
+    double sum = 0.0;
+    for (double sample : samples) sum += sample;
+    result.meanNs = sum / samples.size();
+    double variance = 0.0;
+    for (double sample : samples) variance += (sample - result.meanNs) * (sample - result.meanNs);
+    result.stddevNs = samples.size() > 1 ? std::sqrt(variance / (samples.size() - 1)) : 0.0;
+    result.itemNs = result.medianNs / std::max(scale, 1);
+    results.push_back(result);
+
+    std::printf("%-28s %7d %14.1f %14.1f %8.1f%% %12.2f\n", name.c_str(), scale, result.medianNs, result.p95Ns,
+                result.meanNs > 0.0 ? 100.0 * result.stddevNs / result.meanNs : 0.0, result.itemNs);
+    std::fflush(stdout);
+}
+
+bool writeBenchmarkJson(const std::string& path, const std::vector<BenchmarkResult>& results) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        std::fprintf(stderr, "ERROR: Failed to open %s\n", path.c_str());
+        return false;
+    }
+
+    // One benchmark per line so baselines can be read back without a JSON parser
+    std::fputs("{\"benchmarks\":[\n", file);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& r = results[i];
+        std::fprintf(file,
+                     "{\"name\":\"%s\",\"scale\":%d,\"repetitions\":%d,\"iterations\":%lld,\"min_ns\":%.1f,"
+                     "\"median_ns\":%.1f,\"mean_ns\":%.1f,\"stddev_ns\":%.1f,\"p95_ns\":%.1f,\"max_ns\":%.1f,\"item_ns\":%.3f}%s\n",
+                     r.name.c_str(), r.scale, r.repetitions, (long long)r.iterationsPerRepetition, r.minNs,
+                     r.medianNs, r.meanNs, r.stddevNs, r.p95Ns, r.maxNs, r.itemNs, i + 1 < results.size() ? "," : "");
+    }
+    std::fputs("]}\n", file);
+    return std::fclose(file) == 0;
+}
+
+bool readBenchmarkBaseline(const std::string& path, std::vector<BenchmarkBaseline>& baseline) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::fprintf(stderr, "ERROR: Failed to open baseline %s\n", path.c_str());
+        return false;
+    }
+
+    baseline.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        const char* name = findJsonValue(line, "name");
+        const char* scale = findJsonValue(line, "scale");
+        const char* median = findJsonValue(line, "median_ns");
+        if (!name || !scale || !median || *name != '"') continue;
+
+        const char* nameEnd = std::strchr(name + 1, '"');
+        if (!nameEnd) continue;
+        BenchmarkBaseline entry;
+        entry.name.assign(name + 1, nameEnd);
+        entry.scale = std::atoi(scale);
+        entry.medianNs = std::atof(median);
+        baseline.push_back(entry);
+    }
+    return true;
+}
@@ -0,0 +1,74 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct BenchmarkOptions {
+    int warmupRepetitions = 2;
+    int repetitions = 10;
+    // Short bodies are looped until one repetition takes at least this long
+    double minRepetitionMs = 5.0;
+    int maxScale = 10000;
+    std::string filter;
+};
+
+// Timing of one benchmark at one scale. Times are per call of the body;
+// itemNs divides the median by the scale (drones, rings, samples or meshes).
+struct BenchmarkResult {
+    std::string name;
+    int scale = 0;
+    int repetitions = 0;
+    int64_t iterationsPerRepetition = 0;
+    double minNs = 0.0;
+    double medianNs = 0.0;
+    double meanNs = 0.0;
+    double stddevNs = 0.0;
+    double p95Ns = 0.0;
+    double maxNs = 0.0;
+    double itemNs = 0.0;
+};
+
+// Median of a previous run, keyed by name and scale
+struct BenchmarkBaseline {
+    std::string name;
+    int scale = 0;
+    double medianNs = 0.0;
+};
+
+// Runs bodies with warmup and repetitions and keeps the results.
+//
+//     BenchmarkRunner runner(options);
+//     runner.run("mission_ring_collision", 100, [&] { ... });
+//     writeBenchmarkJson("bench.json", runner.getResults());
+class BenchmarkRunner {
+public:
+    explicit BenchmarkRunner(const BenchmarkOptions& options);
+    bool isSelected(const std::string& name, int scale) const;
+    // body runs the measured operation once at the given scale; setup (if any) runs untimed before each repetition
+    void run(const std::string& name, int scale, const std::function<void()>& body,
+             const std::function<void()>& setup = std::function<void()>());
+    const std::vector<BenchmarkResult>& getResults() const { return results; }
+private:
+    BenchmarkOptions options;
+    std::vector<BenchmarkResult> results;
+};
+
+bool writeBenchmarkJson(const std::string& path, const std::vector<BenchmarkResult>& results);
+// Reads the name/scale/median of every benchmark in a file written by writeBenchmarkJson
+bool readBenchmarkBaseline(const std::string& path, std::vector<BenchmarkBaseline>& baseline);
+
+// Keeps the optimizer from discarding a benchmark's result
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
+
+#endif
@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench/benchmark.h"
+#include "controls/controls.h"
+#include "logging/logger.h"
+#include "mission/mission.h"
+#include "physics/physics.h"
+#include "renderer/mesh_builder.h"
+#include "sim/determinism.h"
+#include "sim/world_snapshot.h"
+
+namespace {
+
+const int kScales[] = {1, 100, 10000};
+
+// Deterministic positions scattered around the default course
+std::vector<glm::vec3> makePositions(int count, uint64_t stream) {
+    std::vector<glm::vec3> positions(count);
+    RandomStream random(0, stream);
+    for (auto& position : positions) {
+        float x = random.nextFloat(-2.0f, 18.0f);
+        float y = random.nextFloat(0.0f, 4.0f);
+        float z = random.nextFloat(-4.0f, 4.0f);
+        position = glm::vec3(x, y, z);
+    }
+    return positions;
+}
+
+// Step time as the body count grows, single-threaded and (with DRONE_BULLET_MT) on workerThreads threads
+const int kStepScales[] = {1, 100, 1000, 10000};
+
+void benchPhysicsStep(BenchmarkRunner& runner, const char* name, int workerThreads) {
+    for (int scale : kStepScales) {
+        if (!runner.isSelected(name, scale)) continue;
+        // All drones share one world, spawned on a 1 m grid so they start apart
+        Physics physics;
+        if (!physics.init(scale, workerThreads)) return;
+        if (workerThreads != 0 && !physics.isMultithreaded()) return;
+        std::vector<DroneId> drones;
+        drones.push_back(physics.getPrimaryDrone());
+        int side = (int)std::ceil(std::sqrt((double)scale));
+        for (int i = 1; i < scale; ++i) {
+            drones.push_back(physics.spawnDrone(glm::vec3((i % side) * 1.0f, 5.0f, (i / side) * 1.0f + 2.0f)));
+        }
+        runner.run(name, scale,
+                   [&] {
+                       for (DroneId drone : drones) {
+                           physics.applyThrust(drone, glm::vec3(0.0f, 9.0f, 0.0f));
+                       }
+                       physics.stepFixed(1.0f / 120.0f);
+                   },
+                   [&] {
+                       for (DroneId drone : drones) physics.resetDrone(drone);
+                   });
+    }
+}
+
+void benchPhysics(BenchmarkRunner& runner, int physicsThreads) {
+    benchPhysicsStep(runner, "physics_step", 0);
+#if defined(DRONE_BULLET_MT) && DRONE_BULLET_MT
+    benchPhysicsStep(runner, "physics_step_mt", physicsThreads);
+#else
+    (void)physicsThreads;
+#endif
+}
+
+// Per-drone getters against the bulk SoA export, and per-drone thrust against applyForces
+void benchStateExport(BenchmarkRunner& runner) {
+    for (int scale : kScales) {
+        bool selected = runner.isSelected("physics_state_per_drone", scale) || runner.isSelected("physics_state_export", scale) ||
+                        runner.isSelected("physics_thrust_per_drone", scale) || runner.isSelected("physics_apply_forces", scale);
+        if (!selected) continue;
+        Physics physics;
+        if (!physics.init(scale)) return;
+        std::vector<DroneId> drones;
+        drones.push_back(physics.getPrimaryDrone());
+        for (int i = 1; i < scale; ++i) {
+            drones.push_back(physics.spawnDrone(glm::vec3((float)i, 5.0f, 2.0f)));
+        }
+
+        std::vector<float> positions(3 * scale), orientations(4 * scale), linear(3 * scale), angular(3 * scale);
+        runner.run("physics_state_per_drone", scale, [&] {
+            for (DroneId drone : drones) {
+                glm::vec3 position = physics.getDronePosition(drone);
+                glm::quat orientation = physics.getDroneOrientation(drone);
+                glm::vec3 velocity = physics.getDroneVelocity(drone);
+                glm::vec3 angularVelocity = glm::vec3(0.0f);
+                if (btRigidBody* body = physics.getDroneBody(drone)) {
+                    const btVector3& w = body->getAngularVelocity();
+                    angularVelocity = glm::vec3(w.x(), w.y(), w.z());
+                }
+                for (int k = 0; k < 3; ++k) {
+                    positions[3 * drone + k] = position[k];
+                    linear[3 * drone + k] = velocity[k];
+                    angular[3 * drone + k] = angularVelocity[k];
+                }
+                orientations[4 * drone + 0] = orientation.x;
+                orientations[4 * drone + 1] = orientation.y;
+                orientations[4 * drone + 2] = orientation.z;
+                orientations[4 * drone + 3] = orientation.w;
+            }
+            doNotOptimize(positions.data());
+        });
+        DroneStateBuffers buffers;
+        buffers.positions = positions.data();
+        buffers.orientations = orientations.data();
+        buffers.linearVelocities = linear.data();
+        buffers.angularVelocities = angular.data();
+        runner.run("physics_state_export", scale, [&] {
+            doNotOptimize(physics.exportDroneStates(buffers));
+        });
+
+        std::vector<float> forces(3 * scale, 1.0f);
+        runner.run("physics_thrust_per_drone", scale, [&] {
+            for (DroneId drone : drones) {
+                physics.applyThrust(drone, glm::vec3(forces[3 * drone], forces[3 * drone + 1], forces[3 * drone + 2]));
+            }
+        });
+        runner.run("physics_apply_forces", scale, [&] {
+            physics.applyForces(forces.data());
+        });
+    }
+}
+
+// Saving and restoring every drone body, e.g. to reset an episode or fork rollouts
+void benchSnapshot(BenchmarkRunner& runner) {
+    for (int scale : kScales) {
+        if (!runner.isSelected("world_snapshot_save", scale) && !runner.isSelected("world_snapshot_restore", scale)) continue;
+        Physics physics;
+        if (!physics.init(scale)) return;
+        int side = (int)std::ceil(std::sqrt((double)scale));
+        for (int i = 1; i < scale; ++i) {
+            physics.spawnDrone(glm::vec3((i % side) * 1.0f, 0.3f, (i / side) * 1.0f + 2.0f));
+        }
+        // Let the drones settle on the ground so there are contacts to drop on restore
+        for (int i = 0; i < 10; ++i) {
+            physics.stepFixed(1.0f / 120.0f);
+        }
+
+        WorldSnapshot snapshot;
+        runner.run("world_snapshot_save", scale, [&] {
+            SnapshotWriter writer(snapshot);
+            physics.saveState(writer);
+            doNotOptimize(snapshot.bytes.data());
+        });
+        runner.run("world_snapshot_restore", scale, [&] {
+            SnapshotReader reader(snapshot);
+            doNotOptimize(physics.restoreState(reader));
+        });
+    }
+}
+
+void benchMission(BenchmarkRunner& runner) {
+    for (int scale : kScales) {
+        if (!runner.isSelected("mission_ring_collision", scale)) continue;
+        // A course of scale rings checked against scale drones
+        Mission mission;
+        mission.setRingPositions(makePositions(scale, 1));
+        std::vector<glm::vec3> drones = makePositions(scale, 2);
+        runner.run("mission_ring_collision", scale, [&] {
+            int hits = 0;
+            for (const auto& drone : drones) {
+                hits += mission.checkRingCollision(drone, 0.5f) ? 1 : 0;
+            }
+            doNotOptimize(hits);
+        });
+    }
+}
+
+void benchLogging(BenchmarkRunner& runner, const std::string& logPath) {
+    bool selected = false;
+    for (int scale : kScales) selected = selected || runner.isSelected("controls_log_data", scale);
+    if (!selected) return;
+
+    Controls controls;
+    if (!controls.startLogging(false, logPath)) return;
+    glm::vec3 position(1.0f, 2.0f, 3.0f);
+    glm::vec3 velocity(0.1f, -0.2f, 0.3f);
+    glm::vec3 thrust(0.0f, 15.0f, -5.0f);
+    const TelemetryWriter& telemetry = controls.getTelemetry();
+    // Untimed: let the writer empty the queue so each repetition starts from the logging path
+    auto drainQueue = [&] {
+        while (telemetry.getWrittenCount() < telemetry.getPushedCount()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+    for (int scale : kScales) {
+        if (!runner.isSelected("controls_log_data", scale)) continue;
+        uint64_t pushedBefore = telemetry.getPushedCount();
+        uint64_t droppedBefore = telemetry.getDroppedCount();
+        // One sample per drone per tick
+        runner.run("controls_log_data", scale, [&] {
+            for (int i = 0; i < scale; ++i) {
+                controls.logData(position, velocity, thrust);
+            }
+        }, drainQueue);
+        // A repetition can still outrun the queue; dropped samples are timed on the cheaper drop path
+        uint64_t dropped = telemetry.getDroppedCount() - droppedBefore;
+        uint64_t total = telemetry.getPushedCount() - pushedBefore + dropped;
+        std::printf("%-28s %7d %llu of %llu samples dropped (queue full)\n", "  controls_log_data", scale,
+                    (unsigned long long)dropped, (unsigned long long)total);
+    }
+}
+
+void benchMeshes(BenchmarkRunner& runner) {
+    for (int scale : kScales) {
+        // Full-detail meshes as built by Renderer::createCube/createTorus
+        runner.run("mesh_build_sphere", scale, [&] {
+            for (int i = 0; i < scale; ++i) {
+                MeshData mesh = buildSphere(0.3f, 24, 24);
+                doNotOptimize(mesh.vertices.data());
+            }
+        });
+        runner.run("mesh_build_torus", scale, [&] {
+            for (int i = 0; i < scale; ++i) {
+                MeshData mesh = buildTorus(1.0f, 0.3f, 32, 12);
+                doNotOptimize(mesh.vertices.data());
+            }
+        });
+    }
+}
+
+// Prints the change of every benchmark found in the baseline; returns how many regressed past the threshold
+int compareWithBaseline(const std::vector<BenchmarkResult>& results, const std::vector<BenchmarkBaseline>& baseline,
+                        double thresholdPercent) {
+    int regressions = 0;
+    std::printf("\n%-28s %7s %14s %14s %9s\n", "baseline comparison", "scale", "base (ns)", "now (ns)", "change");
+    for (const auto& result : results) {
+        for (const auto& entry : baseline) {
+            if (entry.name != result.name || entry.scale != result.scale || entry.medianNs <= 0.0) continue;
+            double change = 100.0 * (result.medianNs - entry.medianNs) / entry.medianNs;
+            bool regressed = change > thresholdPercent;
+            regressions += regressed ? 1 : 0;
+            std::printf("%-28s %7d %14.1f %14.1f %+8.1f%%%s\n", result.name.c_str(), result.scale, entry.medianNs,
+                        result.medianNs, change, regressed ? "  REGRESSION" : "");
+        }
+    }
+    return regressions;
+}
+
+}
+
+// Headless micro-benchmarks of the simulation hot paths
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+    std::string jsonPath;
+    std::string baselinePath;
+    std::string logPath = "drone_bench_log.csv";
+    double thresholdPercent = 5.0;
+    int physicsThreads = -1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+            options.repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            options.warmupRepetitions = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc) {
+            options.minRepetitionMs = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-scale") == 0 && i + 1 < argc) {
+            options.maxScale = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            thresholdPercent = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--physics-threads") == 0 && i + 1 < argc) {
+            physicsThreads = std::atoi(argv[++i]);
+            if (physicsThreads <= 0) physicsThreads = -1;
+        } else {
+            std::cerr << "Usage: drone-bench [--filter <substring>] [--repetitions <n>] [--warmup <n>] [--min-time-ms <ms>]"
+                      << " [--max-scale <n>] [--json <out.json>] [--baseline <previous.json>] [--threshold <percent>]"
+                      << " [--physics-threads <n>]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<BenchmarkBaseline> baseline;
+    if (!baselinePath.empty() && !readBenchmarkBaseline(baselinePath, baseline)) {
+        return 1;
+    }
+
+    // Keep init chatter out of the report
+    Logger::instance().setLevel(LOG_LEVEL_WARN);
+
+    std::printf("%-28s %7s %14s %14s %9s %12s\n", "benchmark", "scale", "median (ns)", "p95 (ns)", "cv", "ns/item");
+    BenchmarkRunner runner(options);
+    benchPhysics(runner, physicsThreads);
+    benchStateExport(runner);
+    benchSnapshot(runner);
+    benchMission(runner);
+    benchLogging(runner, logPath);
+    std::remove(logPath.c_str());
+    benchMeshes(runner);
+
+    if (!jsonPath.empty() && writeBenchmarkJson(jsonPath, runner.getResults())) {
+        std::printf("\nWrote %s\n", jsonPath.c_str());
+    }
+    if (!baseline.empty()) {
+        int regressions = compareWithBaseline(runner.getResults(), baseline, thresholdPercent);
+        if (regressions > 0) {
+            std::printf("%d benchmark(s) regressed by more than %.1f%%\n", regressions, thresholdPercent);
+            return 2;
+        }
+    }
+    return 0;
+}
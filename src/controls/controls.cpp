@@ -1,44 +1,79 @@
 #include "controls.h"
-#include <iostream>
-#include <fstream>
 #include <chrono>
+#include "logging/logger.h"
+#include "profiling/profiler.h"
+#include "sim/world_snapshot.h"
+
+namespace {
+
+const uint32_t kControlsSnapshotTag = makeSnapshotTag('C', 'T', 'R', 'L');
+
+// Controller state as plain floats: thrust, target, integral, previous error, then the three gains
+struct ControllerRecord {
+    float vectors[12];
+    float gains[3];
+};
+
+}
 
 Controls::Controls() : thrust(0.0f), targetPosition(0.0f, 5.0f, 0.0f), pidKp(1.0f), pidKi(0.1f), pidKd(0.1f), integral(0.0f), previousError(0.0f) {}
 
 Controls::~Controls() {
-    saveLogToFile();
+    if (telemetry.isRunning()) {
+        telemetry.stop();
+        LOG_INFO("Log saved to " << logPath << " (" << telemetry.getWrittenCount() << " samples, "
+                 << telemetry.getDroppedCount() << " dropped)");
+    }
+}
+
+bool Controls::startLogging(bool binaryFormat, const std::string& path) {
+    // Samples are written in the background as they arrive, so a crash loses at most the last flush interval
+    // (or the open chunk for the binary format)
+    std::unique_ptr<TelemetrySink> sink;
+    if (binaryFormat) {
+        logPath = "data/logs/drone_log.dtl";
+        sink.reset(new BinaryTelemetrySink());
+    } else {
+        logPath = "data/logs/drone_log.csv";
+        sink.reset(new CsvTelemetrySink());
+    }
+    if (!path.empty()) {
+        logPath = path;
+    }
+    return telemetry.start(logPath, std::move(sink));
 }
 
 void Controls::update(float deltaTime, GLFWwindow* window) {
+    PROFILE_SCOPE("Controls::update");
     // Manual controls
     thrust = glm::vec3(0.0f);
     if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) {
         thrust.y += 15.0f; // upward
-        std::cout << "SPACE pressed - upward thrust" << std::endl;
+        LOG_DEBUG_EVERY(500, "SPACE pressed - upward thrust");
     }
     if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) {
         thrust.z -= 5.0f; // forward
-        std::cout << "W pressed - forward thrust" << std::endl;
+        LOG_DEBUG_EVERY(500, "W pressed - forward thrust");
     }
     if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) {
         thrust.z += 5.0f; // backward
-        std::cout << "S pressed - backward thrust" << std::endl;
+        LOG_DEBUG_EVERY(500, "S pressed - backward thrust");
     }
     if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) {
         thrust.x -= 5.0f; // left
-        std::cout << "A pressed - left thrust" << std::endl;
+        LOG_DEBUG_EVERY(500, "A pressed - left thrust");
     }
     if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
         thrust.x += 5.0f; // right
-        std::cout << "D pressed - right thrust" << std::endl;
+        LOG_DEBUG_EVERY(500, "D pressed - right thrust");
     }
     if (glfwGetKey(window, GLFW_KEY_Q) == GLFW_PRESS) {
         thrust.y += 10.0f; // up
-        std::cout << "Q pressed - upward thrust" << std::endl;
+        LOG_DEBUG_EVERY(500, "Q pressed - upward thrust");
     }
     if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS) {
         thrust.y -= 5.0f; // down (less force for controlled descent)
-        std::cout << "E pressed - downward thrust" << std::endl;
+        LOG_DEBUG_EVERY(500, "E pressed - downward thrust");
     }
 
     // PID for auto-hover (simple implementation)
@@ -58,24 +93,54 @@ glm::vec3 Controls::getTargetPosition() {
     return targetPosition;
 }
 
-void Controls::logData(const glm::vec3& position, const glm::vec3& velocity, const glm::vec3& thrust) {
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
-    std::string logEntry = std::to_string(time) + "," +
-                          std::to_string(position.x) + "," + std::to_string(position.y) + "," + std::to_string(position.z) + "," +
-                          std::to_string(velocity.x) + "," + std::to_string(velocity.y) + "," + std::to_string(velocity.z) + "," +
-                          std::to_string(thrust.x) + "," + std::to_string(thrust.y) + "," + std::to_string(thrust.z);
-    logBuffer.push_back(logEntry);
+void Controls::logData(const glm::vec3& position, const glm::vec3& velocity, const glm::vec3& thrust, int64_t timestampMs) {
+    PROFILE_SCOPE("Controls::logData");
+    TelemetrySample sample;
+    if (timestampMs >= 0) {
+        sample.timestampMs = timestampMs;
+    } else {
+        auto now = std::chrono::system_clock::now();
+        sample.timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+    }
+    sample.position[0] = position.x;
+    sample.position[1] = position.y;
+    sample.position[2] = position.z;
+    sample.velocity[0] = velocity.x;
+    sample.velocity[1] = velocity.y;
+    sample.velocity[2] = velocity.z;
+    sample.thrust[0] = thrust.x;
+    sample.thrust[1] = thrust.y;
+    sample.thrust[2] = thrust.z;
+    telemetry.push(sample);
 }
 
-void Controls::saveLogToFile() {
-    std::ofstream file("data/logs/drone_log.csv");
-    if (file.is_open()) {
-        file << "timestamp,pos_x,pos_y,pos_z,vel_x,vel_y,vel_z,thrust_x,thrust_y,thrust_z\n";
-        for (const auto& entry : logBuffer) {
-            file << entry << "\n";
+void Controls::saveState(SnapshotWriter& writer) const {
+    ControllerRecord record;
+    const glm::vec3* vectors[] = {&thrust, &targetPosition, &integral, &previousError};
+    for (int i = 0; i < 4; ++i) {
+        for (int k = 0; k < 3; ++k) {
+            record.vectors[3 * i + k] = (*vectors[i])[k];
         }
-        file.close();
-        std::cout << "Log saved to data/logs/drone_log.csv" << std::endl;
     }
-}
\ No newline at end of file
+    record.gains[0] = pidKp;
+    record.gains[1] = pidKi;
+    record.gains[2] = pidKd;
+    writer.write(kControlsSnapshotTag);
+    writer.write(record);
+}
+
+bool Controls::restoreState(SnapshotReader& reader) {
+    ControllerRecord record;
+    if (!reader.expectTag(kControlsSnapshotTag) || !reader.read(record)) {
+        LOG_ERROR("Invalid controls snapshot");
+        return false;
+    }
+    glm::vec3* vectors[] = {&thrust, &targetPosition, &integral, &previousError};
+    for (int i = 0; i < 4; ++i) {
+        *vectors[i] = glm::vec3(record.vectors[3 * i], record.vectors[3 * i + 1], record.vectors[3 * i + 2]);
+    }
+    pidKp = record.gains[0];
+    pidKi = record.gains[1];
+    pidKd = record.gains[2];
+    return true;
+}
@@ -3,8 +3,10 @@
 
 #include <glm/glm.hpp>
 #include <GLFW/glfw3.h>
-#include <vector>
-#include <string>
+#include "telemetry/telemetry_writer.h"
+
+class SnapshotWriter;
+class SnapshotReader;
 
 class Controls {
 public:
@@ -14,15 +16,23 @@ public:
     glm::vec3 getThrust();
     void setTargetPosition(const glm::vec3& pos);
     glm::vec3 getTargetPosition();
-    void logData(const glm::vec3& position, const glm::vec3& velocity, const glm::vec3& thrust);
+    // Starts the background flight log writer; binary selects the compressed .dtl format over CSV.
+    // An empty path logs to data/logs/drone_log.{csv,dtl}.
+    bool startLogging(bool binaryFormat, const std::string& path = std::string());
+    // timestampMs < 0 stamps the sample with the wall clock; deterministic runs pass simulation time
+    void logData(const glm::vec3& position, const glm::vec3& velocity, const glm::vec3& thrust, int64_t timestampMs = -1);
+    // Controller state (thrust, target, PID gains and integrator); logging isn't affected
+    void saveState(SnapshotWriter& writer) const;
+    bool restoreState(SnapshotReader& reader);
+    const TelemetryWriter& getTelemetry() const { return telemetry; }
 private:
     glm::vec3 thrust;
     glm::vec3 targetPosition;
     float pidKp, pidKi, pidKd;
     glm::vec3 integral;
     glm::vec3 previousError;
-    std::vector<std::string> logBuffer;
-    void saveLogToFile();
+    TelemetryWriter telemetry;
+    std::string logPath;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "logger.h"
+#include <chrono>
+#include <cstdio>
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() : queueHead(0), queueCount(0), running(false), stopRequested(false), droppedMessages(0),
+                   minLevel(LOG_LEVEL_DEBUG) {}
+
+Logger::~Logger() {
+    stop();
+}
+
+void Logger::start(size_t queueCapacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) return;
+
+    queue.resize(queueCapacity > 0 ? queueCapacity : 1);
+    queueHead = 0;
+    queueCount = 0;
+    stopRequested = false;
+    running = true;
+    thread = std::thread(&Logger::run, this);
+}
+
+void Logger::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        stopRequested = true;
+    }
+    messageAvailable.notify_one();
+    thread.join();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    running = false;
+}
+
+void Logger::submit(LogLevel level, const char* text, size_t length) {
+    if (length > kMaxMessageLength) length = kMaxMessageLength;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!running || stopRequested) {
+        // No sink thread: write in place, still serialized by the lock
+        Message message;
+        message.level = level;
+        message.length = length;
+        std::char_traits<char>::copy(message.text, text, length);
+        write(message);
+        std::fflush(level >= LOG_LEVEL_WARN ? stderr : stdout);
+        return;
+    }
+
+    if (queueCount == queue.size()) {
+        droppedMessages.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Message& message = queue[(queueHead + queueCount) % queue.size()];
+    message.level = level;
+    message.length = length;
+    std::char_traits<char>::copy(message.text, text, length);
+    bool wasEmpty = queueCount == 0;
+    ++queueCount;
+    lock.unlock();
+
+    if (wasEmpty) {
+        messageAvailable.notify_one();
+    }
+}
+
+void Logger::run() {
+    std::vector<Message> batch;
+    batch.reserve(queue.size());
+    uint64_t reportedDrops = 0;
+
+    for (;;) {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            messageAvailable.wait(lock, [this] { return queueCount > 0 || stopRequested; });
+            // Copy the whole backlog out so the terminal I/O below happens without the lock
+            batch.clear();
+            while (queueCount > 0) {
+                batch.push_back(queue[queueHead]);
+                queueHead = (queueHead + 1) % queue.size();
+                --queueCount;
+            }
+            stopping = stopRequested;
+        }
+
+        for (const auto& message : batch) {
+            write(message);
+        }
+        uint64_t drops = droppedMessages.load(std::memory_order_relaxed);
+        if (drops != reportedDrops) {
+            std::fprintf(stderr, "WARNING: %llu log messages dropped\n", (unsigned long long)(drops - reportedDrops));
+            reportedDrops = drops;
+        }
+        std::fflush(stdout);
+        std::fflush(stderr);
+
+        if (stopping) break;
+    }
+}
+
+void Logger::write(const Message& message) {
+    FILE* out = message.level >= LOG_LEVEL_WARN ? stderr : stdout;
+    if (message.level == LOG_LEVEL_ERROR) {
+        std::fputs("ERROR: ", out);
+    } else if (message.level == LOG_LEVEL_WARN) {
+        std::fputs("WARNING: ", out);
+    }
+    std::fwrite(message.text, 1, message.length, out);
+    std::fputc('\n', out);
+}
+
+LogRateLimiter::LogRateLimiter(int intervalMs)
+    : intervalNs((int64_t)intervalMs * 1000000), nextAllowedNs(0), suppressedCount(0) {}
+
+bool LogRateLimiter::allow(uint64_t& suppressed) {
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t next = nextAllowedNs.load(std::memory_order_relaxed);
+    if (now < next || !nextAllowedNs.compare_exchange_strong(next, now + intervalNs, std::memory_order_relaxed)) {
+        suppressedCount.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    suppressed = suppressedCount.exchange(0, std::memory_order_relaxed);
+    return true;
+}
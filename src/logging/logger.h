@@ -0,0 +1,144 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+enum LogLevel {
+    LOG_LEVEL_DEBUG = 0,
+    LOG_LEVEL_INFO = 1,
+    LOG_LEVEL_WARN = 2,
+    LOG_LEVEL_ERROR = 3,
+    LOG_LEVEL_OFF = 4
+};
+
+// Messages below this level compile to nothing; override with -DDRONE_LOG_MIN_LEVEL=<level>
+#ifndef DRONE_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define DRONE_LOG_MIN_LEVEL 1
+#else
+#define DRONE_LOG_MIN_LEVEL 0
+#endif
+#endif
+
+// Process-wide console logger. Callers format into a fixed-size message and
+// enqueue it; a background thread writes queued messages to stdout/stderr in
+// batches with one flush per batch. When the queue is full, messages are
+// dropped and counted. Before start() (and after stop()) messages are written
+// synchronously, so early startup errors are never lost.
+class Logger {
+public:
+    static const size_t kMaxMessageLength = 512;
+
+    static Logger& instance();
+    ~Logger();
+
+    void start(size_t queueCapacity = 1024);
+    // Writes everything still queued, then joins the sink thread
+    void stop();
+
+    // Runtime cutoff on top of DRONE_LOG_MIN_LEVEL; messages below it are not even formatted
+    void setLevel(LogLevel level) { minLevel.store(level, std::memory_order_relaxed); }
+    bool isEnabled(LogLevel level) const { return level >= minLevel.load(std::memory_order_relaxed); }
+
+    void submit(LogLevel level, const char* text, size_t length);
+    uint64_t getDroppedCount() const { return droppedMessages.load(std::memory_order_relaxed); }
+private:
+    struct Message {
+        LogLevel level;
+        size_t length;
+        char text[kMaxMessageLength];
+    };
+
+    Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    std::vector<Message> queue;
+    size_t queueHead;
+    size_t queueCount;
+    std::mutex mutex;
+    std::condition_variable messageAvailable;
+    std::thread thread;
+    bool running;
+    bool stopRequested;
+    std::atomic<uint64_t> droppedMessages;
+    std::atomic<int> minLevel;
+
+    void run();
+    static void write(const Message& message);
+};
+
+// Lets at most one message through per interval; counts the rest
+class LogRateLimiter {
+public:
+    explicit LogRateLimiter(int intervalMs);
+    // True if this call may log; suppressed receives how many were skipped since the last one
+    bool allow(uint64_t& suppressed);
+private:
+    const int64_t intervalNs;
+    std::atomic<int64_t> nextAllowedNs;
+    std::atomic<uint64_t> suppressedCount;
+};
+
+// Stream buffer over a fixed array; characters beyond the end are discarded
+class LogStreamBuffer : public std::streambuf {
+public:
+    LogStreamBuffer(char* buffer, size_t size) { setp(buffer, buffer + size); }
+    size_t length() const { return pptr() - pbase(); }
+protected:
+    int_type overflow(int_type c) override { return traits_type::not_eof(c); }
+};
+
+// One message being formatted on the caller's stack; submitted on destruction
+class LogLine {
+public:
+    explicit LogLine(LogLevel level) : level(level), buffer(text, sizeof(text)), stream(&buffer) {}
+    ~LogLine() { Logger::instance().submit(level, text, buffer.length()); }
+    std::ostream& getStream() { return stream; }
+private:
+    LogLevel level;
+    char text[Logger::kMaxMessageLength];
+    LogStreamBuffer buffer;
+    std::ostream stream;
+};
+
+#define DRONE_LOG(level, message) \
+    do { \
+        if ((level) >= DRONE_LOG_MIN_LEVEL && Logger::instance().isEnabled(level)) { \
+            LogLine logLine_(level); \
+            logLine_.getStream() << message; \
+        } \
+    } while (0)
+
+// At most one message per intervalMs from this call site; the next one reports how many were skipped
+#define DRONE_LOG_EVERY(level, intervalMs, message) \
+    do { \
+        if ((level) >= DRONE_LOG_MIN_LEVEL && Logger::instance().isEnabled(level)) { \
+            static LogRateLimiter logLimiter_(intervalMs); \
+            uint64_t logSuppressed_ = 0; \
+            if (logLimiter_.allow(logSuppressed_)) { \
+                LogLine logLine_(level); \
+                logLine_.getStream() << message; \
+                if (logSuppressed_ > 0) logLine_.getStream() << " (" << logSuppressed_ << " similar suppressed)"; \
+            } \
+        } \
+    } while (0)
+
+#define LOG_DEBUG(message) DRONE_LOG(LOG_LEVEL_DEBUG, message)
+#define LOG_INFO(message) DRONE_LOG(LOG_LEVEL_INFO, message)
+#define LOG_WARN(message) DRONE_LOG(LOG_LEVEL_WARN, message)
+#define LOG_ERROR(message) DRONE_LOG(LOG_LEVEL_ERROR, message)
+
+#define LOG_DEBUG_EVERY(intervalMs, message) DRONE_LOG_EVERY(LOG_LEVEL_DEBUG, intervalMs, message)
+#define LOG_INFO_EVERY(intervalMs, message) DRONE_LOG_EVERY(LOG_LEVEL_INFO, intervalMs, message)
+#define LOG_WARN_EVERY(intervalMs, message) DRONE_LOG_EVERY(LOG_LEVEL_WARN, intervalMs, message)
+
+#endif
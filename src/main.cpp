@@ -1,23 +1,69 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
-#include <iostream>
 #include "renderer/renderer.h"
 #include "physics/physics.h"
+#include "physics/debug_drawer.h"
 #include "controls/controls.h"
 #include "mission/mission.h"
-#include "mission/mission.h"
+#include "sim/sim_thread.h"
+#include "telemetry/flight_recorder.h"
+#include "profiling/profiler.h"
+#include "profiling/frame_stats.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "logging/logger.h"
 
 void glfwErrorCallback(int error, const char* description) {
-    std::cerr << "GLFW Error (" << error << "): " << description << std::endl;
+    LOG_ERROR("GLFW Error (" << error << "): " << description);
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // Parse command line options
+    double tickRate = 120.0;
+    int maxTicksPerFrame = 8;
+    bool binaryLog = false;
+    const char* blackBoxPath = nullptr;
+    int blackBoxSeconds = 60;
+    int physicsThreads = 0;
+    bool deterministic = false;
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            tickRate = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-ticks-per-frame") == 0 && i + 1 < argc) {
+            maxTicksPerFrame = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--log-format") == 0 && i + 1 < argc) {
+            binaryLog = std::strcmp(argv[++i], "binary") == 0;
+        } else if (std::strcmp(argv[i], "--black-box") == 0 && i + 1 < argc) {
+            blackBoxPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--black-box-seconds") == 0 && i + 1 < argc) {
+            blackBoxSeconds = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--physics-threads") == 0 && i + 1 < argc) {
+            physicsThreads = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--deterministic") == 0) {
+            deterministic = true;
+        } else if (std::strcmp(argv[i], "--record-inputs") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+            deterministic = true;
+        } else if (std::strcmp(argv[i], "--replay-inputs") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+            deterministic = true;
+        }
+    }
+
+    // Console output goes through the background logger from here on
+    Logger::instance().start();
+
     // Set GLFW error callback
     glfwSetErrorCallback(glfwErrorCallback);
 
     // Initialize GLFW
     if (!glfwInit()) {
-        std::cerr << "Failed to initialize GLFW" << std::endl;
+        LOG_ERROR("Failed to initialize GLFW");
         return -1;
     }
 
@@ -31,7 +77,7 @@ int main() {
     // Create a windowed GLFW window with reasonable size
     GLFWwindow* window = glfwCreateWindow(1024, 768, "3D Drone Racing Lite", NULL, NULL);
     if (!window) {
-        std::cerr << "Failed to create GLFW window" << std::endl;
+        LOG_ERROR("Failed to create GLFW window");
         glfwTerminate();
         return -1;
     }
@@ -44,19 +90,19 @@ int main() {
 
     // Load OpenGL functions using GLAD
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        std::cerr << "Failed to initialize GLAD" << std::endl;
+        LOG_ERROR("Failed to initialize GLAD");
         return -1;
     }
 
     // Validate OpenGL context
-    std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
-    std::cout << "GLSL Version: " << glGetString(GL_SHADING_LANGUAGE_VERSION) << std::endl;
-    std::cout << "Renderer: " << glGetString(GL_RENDERER) << std::endl;
-    std::cout << "Vendor: " << glGetString(GL_VENDOR) << std::endl;
+    LOG_INFO("OpenGL Version: " << glGetString(GL_VERSION));
+    LOG_INFO("GLSL Version: " << glGetString(GL_SHADING_LANGUAGE_VERSION));
+    LOG_INFO("Renderer: " << glGetString(GL_RENDERER));
+    LOG_INFO("Vendor: " << glGetString(GL_VENDOR));
 
     // Check for required extensions
     if (!GLAD_GL_VERSION_3_3) {
-        std::cerr << "OpenGL 3.3 is not supported!" << std::endl;
+        LOG_ERROR("OpenGL 3.3 is not supported!");
         return -1;
     }
 
@@ -74,43 +120,97 @@ int main() {
     // Initialize renderer
     Renderer renderer;
     if (!renderer.init()) {
-        std::cerr << "Failed to initialize renderer" << std::endl;
+        LOG_ERROR("Failed to initialize renderer");
         glfwTerminate();
         return -1;
     }
 
+    // GPU pass timing; the renderer simply skips it if queries are unavailable
+    GpuTimer gpuTimer;
+    gpuTimer.init();
+    renderer.setGpuTimer(&gpuTimer);
+
     // Initialize physics
     Physics physics;
-    if (!physics.init()) {
-        std::cerr << "Failed to initialize physics" << std::endl;
+    if (!physics.init(Physics::kDefaultMaxDrones, physicsThreads)) {
+        LOG_ERROR("Failed to initialize physics");
         glfwTerminate();
         return -1;
     }
 
+    // Deterministic runs need the single-threaded world; without it, carry on as a normal run
+    if (deterministic && !physics.setDeterministic(true)) {
+        LOG_WARN("Deterministic mode disabled");
+        deterministic = false;
+        recordPath = nullptr;
+        replayPath = nullptr;
+    }
+
+    // Attach the GL debug drawer to the physics world
+    DebugDrawer debugDrawer;
+    physics.setDebugDrawer(&debugDrawer, &debugDrawer);
+
     // Initialize controls
     Controls controls;
+    controls.startLogging(binaryLog);
 
     // Initialize mission
     Mission mission;
     mission.init();
 
     // Print control instructions
-    std::cout << "\n=== 3D Drone Racing Lite Controls ===" << std::endl;
-    std::cout << "Movement: WASD (forward/back/left/right)" << std::endl;
-    std::cout << "Vertical: Q (up), E (down)" << std::endl;
-    std::cout << "Thrust: SPACE (additional upward force)" << std::endl;
-    std::cout << "Camera: Arrow keys (orbit), Right-click + mouse (look around)" << std::endl;
-    std::cout << "Reset: R (drone & mission), C (camera)" << std::endl;
-    std::cout << "Debug: F1 (physics visualization), F2 (performance info)" << std::endl;
-    std::cout << "=====================================\n" << std::endl;
+    LOG_INFO("\n=== 3D Drone Racing Lite Controls ===");
+    LOG_INFO("Movement: WASD (forward/back/left/right)");
+    LOG_INFO("Vertical: Q (up), E (down)");
+    LOG_INFO("Thrust: SPACE (additional upward force)");
+    LOG_INFO("Camera: Arrow keys (orbit), Right-click + mouse (look around)");
+    LOG_INFO("Reset: R (drone & mission), C (camera)");
+    LOG_INFO("Debug: F1 (physics visualization), F2 (performance info)");
+    LOG_INFO("=====================================\n");
+
+    // Optional crash-safe recorder of the last few seconds, written by the simulation thread every tick
+    FlightRecorder blackBox;
+    if (blackBoxPath) {
+        uint32_t capacity = (uint32_t)(std::max(blackBoxSeconds, 1) * std::max(tickRate, 1.0));
+        if (blackBox.open(blackBoxPath, capacity)) {
+            LOG_INFO("Flight recorder: " << blackBoxPath << " (" << capacity << " records)");
+        }
+    }
+    float cpuFrameSeconds = 0.0f;
+
+    // Run physics and mission on their own thread at a fixed tick rate, decoupled from vsync.
+    // From here on the render thread only sees the world through published snapshots.
+    SimulationThread simThread(physics, mission);
+    simThread.setDeterministic(deterministic);
+    if (blackBox.isOpen()) simThread.setFlightRecorder(&blackBox);
+    if (recordPath) simThread.startRecording(recordPath);
+    if (replayPath) simThread.startReplay(replayPath);
+    simThread.start(tickRate, maxTicksPerFrame);
+    uint64_t lastLoggedTick = 0;
+    uint64_t lastLoadCount = 0;
+
+    // Tail latency per frame stage, reported to data/logs/frame_stats.csv at exit
+    FrameStats frameStats;
+    std::chrono::steady_clock::time_point lastFrameStart;
+    bool haveLastFrameStart = false;
+    char title[256];
+    bool titleDirty = true;
+    int titleRingIndex = -1;
 
     // Main render loop
+    PROFILE_THREAD_NAME("Main");
     float lastTime = glfwGetTime();
     float fpsUpdateTimer = 0.0f;
     int frameCount = 0;
     float fps = 0.0f;
 
     while (!glfwWindowShouldClose(window)) {
+        auto frameStart = std::chrono::steady_clock::now();
+        if (haveLastFrameStart) {
+            frameStats.recordFrame(std::chrono::duration_cast<std::chrono::nanoseconds>(frameStart - lastFrameStart).count());
+        }
+        lastFrameStart = frameStart;
+        haveLastFrameStart = true;
         float currentTime = glfwGetTime();
         float deltaTime = currentTime - lastTime;
         lastTime = currentTime;
@@ -118,17 +218,20 @@ int main() {
         // Update FPS counter
         frameCount++;
         fpsUpdateTimer += deltaTime;
+        bool fpsUpdated = false;
         if (fpsUpdateTimer >= 0.5f) { // Update FPS every 0.5 seconds
             fps = frameCount / fpsUpdateTimer;
+            fpsUpdated = true;
+            titleDirty = true;
             frameCount = 0;
             fpsUpdateTimer = 0.0f;
         }
 
         // Update controls
-        controls.update(deltaTime, window);
-
-        // Apply thrust from controls
-        physics.applyThrust(controls.getThrust());
+        {
+            LatencyScope latency(frameStats.get(FRAME_STAGE_CONTROLS));
+            controls.update(deltaTime, window);
+        }
 
         // Enhanced camera controls
         if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
@@ -188,21 +291,25 @@ int main() {
         // Enhanced keyboard shortcuts
         static bool debugKeyPressed = false;
         if (glfwGetKey(window, GLFW_KEY_F1) == GLFW_PRESS && !debugKeyPressed) {
-            physics.toggleDebugMode();
+            simThread.withWorldLocked([&] { physics.toggleDebugMode(); });
             debugKeyPressed = true;
-            std::cout << "Debug mode " << (physics.isDebugModeEnabled() ? "enabled" : "disabled") << std::endl;
+            titleDirty = true;
+            LOG_INFO("Debug mode " << (physics.isDebugModeEnabled() ? "enabled" : "disabled"));
         }
         if (glfwGetKey(window, GLFW_KEY_F1) == GLFW_RELEASE) {
             debugKeyPressed = false;
         }
 
         // Reset drone and mission
+        InputCommand input;
+        input.thrust = controls.getThrust();
+        input.frameSeconds = deltaTime;
+        input.cpuFrameSeconds = cpuFrameSeconds;
         static bool resetKeyPressed = false;
         if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS && !resetKeyPressed) {
-            physics.resetDrone();
-            mission.reset();
+            input.resetRequested = true;
             resetKeyPressed = true;
-            std::cout << "Drone and mission reset!" << std::endl;
+            LOG_INFO("Drone and mission reset!");
         }
         if (glfwGetKey(window, GLFW_KEY_R) == GLFW_RELEASE) {
             resetKeyPressed = false;
@@ -213,7 +320,7 @@ int main() {
         if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS && !cameraResetPressed) {
             renderer.resetCamera();
             cameraResetPressed = true;
-            std::cout << "Camera reset to default position!" << std::endl;
+            LOG_INFO("Camera reset to default position!");
         }
         if (glfwGetKey(window, GLFW_KEY_C) == GLFW_RELEASE) {
             cameraResetPressed = false;
@@ -225,36 +332,84 @@ int main() {
         if (glfwGetKey(window, GLFW_KEY_F2) == GLFW_PRESS && !perfInfoPressed) {
             showPerfInfo = !showPerfInfo;
             perfInfoPressed = true;
-            std::cout << "Performance info " << (showPerfInfo ? "enabled" : "disabled") << std::endl;
+            titleDirty = true;
+            LOG_INFO("Performance info " << (showPerfInfo ? "enabled" : "disabled"));
         }
         if (glfwGetKey(window, GLFW_KEY_F2) == GLFW_RELEASE) {
             perfInfoPressed = false;
         }
 
-        // Step physics
-        physics.step(deltaTime);
+        // Capture a CPU trace of the next few seconds
+        static bool profileKeyPressed = false;
+        if (glfwGetKey(window, GLFW_KEY_F3) == GLFW_PRESS && !profileKeyPressed) {
+            Profiler::instance().requestCapture(300, "data/logs/profile_trace.json");
+            profileKeyPressed = true;
+        }
+        if (glfwGetKey(window, GLFW_KEY_F3) == GLFW_RELEASE) {
+            profileKeyPressed = false;
+        }
 
-        // Get drone position and update renderer
-        glm::vec3 dronePos = physics.getDronePosition();
-        renderer.setDronePosition(dronePos.x, dronePos.y, dronePos.z);
+        // Quick save/load; the controller's state rides along with the save request so the
+        // simulation thread stores it in the same snapshot as the world
+        static bool saveKeyPressed = false;
+        static bool loadKeyPressed = false;
+        if (glfwGetKey(window, GLFW_KEY_F5) == GLFW_PRESS && !saveKeyPressed) {
+            input.saveRequested = true;
+            saveKeyPressed = true;
+            SnapshotWriter writer(input.controllerState);
+            controls.saveState(writer);
+        }
+        if (glfwGetKey(window, GLFW_KEY_F5) == GLFW_RELEASE) {
+            saveKeyPressed = false;
+        }
+        if (glfwGetKey(window, GLFW_KEY_F9) == GLFW_PRESS && !loadKeyPressed) {
+            input.loadRequested = true;
+            loadKeyPressed = true;
+        }
+        if (glfwGetKey(window, GLFW_KEY_F9) == GLFW_RELEASE) {
+            loadKeyPressed = false;
+        }
 
-        // Update mission
-        mission.update(dronePos);
+        // Hand this frame's input to the simulation thread
+        if (!simThread.pushInput(input)) {
+            // Queue full, retry one-shot requests next frame
+            if (input.resetRequested) resetKeyPressed = false;
+            if (input.saveRequested) saveKeyPressed = false;
+            if (input.loadRequested) loadKeyPressed = false;
+        }
 
-        // Update renderer with ring positions
-        renderer.setRingPositions(mission.getRingPositions());
+        // Pick up the newest simulation snapshot
+        simThread.updateSnapshot();
+        const WorldState& snapshot = simThread.getSnapshot();
+
+        // A quick load happened: take the controller back from the loaded snapshot
+        if (snapshot.loadCount != lastLoadCount) {
+            lastLoadCount = snapshot.loadCount;
+            if (!snapshot.loadedControllerState.bytes.empty()) {
+                SnapshotReader reader(snapshot.loadedControllerState);
+                controls.restoreState(reader);
+            }
+        }
 
-        // Check for crash (drone below ground)
-        if (dronePos.y < 0) {
-            mission.reset();
-            // Reset drone position
-            physics.resetDrone();
+        // Log data once per simulated tick we get to see
+        if (snapshot.tick != lastLoggedTick) {
+            PROFILE_SCOPE("Logging");
+            LatencyScope latency(frameStats.get(FRAME_STAGE_LOGGING));
+            // Deterministic runs stamp samples with simulation time. Which ticks get logged still
+            // depends on frame timing, so compare runs by their recorded input hashes, not these logs.
+            int64_t simulationNs = (int64_t)(snapshot.tick * (double)snapshot.tickSeconds * 1e9);
+            controls.logData(snapshot.dronePosition, snapshot.droneVelocity, controls.getThrust(),
+                             deterministic ? simulationNs / 1000000 : -1);
+            lastLoggedTick = snapshot.tick;
         }
 
-        // Log data
-        glm::vec3 droneVel = physics.getDroneVelocity();
-        glm::vec3 thrust = controls.getThrust();
-        controls.logData(dronePos, droneVel, thrust);
+        // Draw the drone between the last two ticks
+        glm::vec3 dronePos = interpolateDronePosition(snapshot, simThread.getInterpolationAlpha());
+        renderer.setDronePosition(dronePos.x, dronePos.y, dronePos.z);
+
+        // Update renderer with ring positions
+        renderer.setRingPositions(snapshot.ringPositions);
+        renderer.setRingProgress(snapshot.currentRingIndex);
 
         // Update camera
         renderer.updateCamera(deltaTime);
@@ -263,6 +418,10 @@ int main() {
         int width, height;
         glfwGetFramebufferSize(window, &width, &height);
         glViewport(0, 0, width, height);
+        renderer.setViewportSize(width, height);
+
+        // Pick up GPU timings from a few frames ago
+        gpuTimer.beginFrame();
 
         // Clear the screen with enhanced atmospheric background
         // Create a gradient sky effect based on time
@@ -271,32 +430,94 @@ int main() {
         float skyG = 0.6f + 0.1f * cos(time * 0.3f);
         float skyB = 0.8f + 0.1f * sin(time * 0.7f);
         glClearColor(skyR, skyG, skyB, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        {
+            PROFILE_SCOPE("Clear");
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        }
 
         // Render scene
-        renderer.render();
-
-        // Render physics debug information
-        physics.renderDebug(renderer.getViewMatrix(), renderer.getProjectionMatrix());
+        {
+            LatencyScope latency(frameStats.get(FRAME_STAGE_RENDER));
+            renderer.render();
+        }
 
-        // Update window title with enhanced info
-        if (showPerfInfo) {
-            std::string title = "3D Drone Racing Lite - FPS: " + std::to_string((int)fps);
+        // Render physics debug information. Only while F1 is on: tracing the world
+        // takes the world lock, which the sim thread holds across catch-up ticks.
+        {
+            LatencyScope latency(frameStats.get(FRAME_STAGE_DEBUG_DRAW));
             if (physics.isDebugModeEnabled()) {
-                title += " [DEBUG]";
+                PROFILE_SCOPE("DebugDraw");
+                debugDrawer.beginFrame();
+                simThread.withWorldLocked([&] {
+                    physics.debugDrawWorld([&](const glm::vec3& center, float radius) {
+                        return renderer.isSphereVisible(center, radius);
+                    });
+                });
             }
-            title += " | Rings: " + std::to_string(mission.getCurrentRingIndex()) + "/" + std::to_string(mission.getTotalRings());
-            glfwSetWindowTitle(window, title.c_str());
-        } else {
-            glfwSetWindowTitle(window, "3D Drone Racing Lite");
+            GpuPassScope gpuPass(physics.isDebugModeEnabled() ? &gpuTimer : nullptr, GPU_PASS_DEBUG_LINES);
+            debugDrawer.render(renderer.getViewMatrix(), renderer.getProjectionMatrix());
+        }
+
+        // Refresh the window title twice a second or when something it shows changes,
+        // formatted into a fixed buffer so the frame loop doesn't allocate
+        if (snapshot.currentRingIndex != titleRingIndex) {
+            titleRingIndex = snapshot.currentRingIndex;
+            titleDirty = true;
+        }
+        if (titleDirty) {
+            if (showPerfInfo) {
+                const LatencyHistogram& frameWindow = frameStats.getWindow();
+                const CullStats& cullStats = renderer.getCullStats();
+                std::snprintf(title, sizeof(title),
+                              "3D Drone Racing Lite - FPS: %d%s | Frame p50/p99/max: %.1f/%.1f/%.1f ms | GPU: %.2f ms | Rings: %d/%d | Visible: %d/%d | Tris: %d",
+                              (int)fps, physics.isDebugModeEnabled() ? " [DEBUG]" : "",
+                              frameWindow.getPercentile(50.0) / 1e6, frameWindow.getPercentile(99.0) / 1e6, frameWindow.getMax() / 1e6,
+                              gpuTimer.getFrameMilliseconds(),
+                              snapshot.currentRingIndex, snapshot.totalRings,
+                              cullStats.visible, cullStats.tested, renderer.getSubmittedTriangles());
+            } else {
+                std::snprintf(title, sizeof(title), "3D Drone Racing Lite");
+            }
+            glfwSetWindowTitle(window, title);
+            titleDirty = false;
+        }
+        if (fpsUpdated) {
+            frameStats.resetWindow();
         }
 
         // Swap buffers and poll events
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+        auto cpuFrameEnd = std::chrono::steady_clock::now();
+        cpuFrameSeconds = std::chrono::duration<float>(cpuFrameEnd - frameStart).count();
+        frameStats.get(FRAME_STAGE_CPU).record(std::chrono::duration_cast<std::chrono::nanoseconds>(cpuFrameEnd - frameStart).count());
+        {
+            PROFILE_SCOPE("Swap");
+            LatencyScope latency(frameStats.get(FRAME_STAGE_SWAP));
+            glfwSwapBuffers(window);
+        }
+        {
+            PROFILE_SCOPE("PollEvents");
+            glfwPollEvents();
+        }
+        PROFILE_END_FRAME();
+    }
+
+    // Stop simulating before the world is torn down
+    simThread.stop();
+
+    // Report tail latency for the whole run
+    frameStats.get(FRAME_STAGE_SIM_TICK).merge(simThread.getTickLatency());
+    frameStats.get(FRAME_STAGE_GPU_SCENE).merge(gpuTimer.getPassHistogram(GPU_PASS_SCENE));
+    frameStats.get(FRAME_STAGE_GPU_RINGS).merge(gpuTimer.getPassHistogram(GPU_PASS_RINGS));
+    frameStats.get(FRAME_STAGE_GPU_DEBUG_LINES).merge(gpuTimer.getPassHistogram(GPU_PASS_DEBUG_LINES));
+    const LatencyHistogram& frameTimes = frameStats.get(FRAME_STAGE_FRAME);
+    LOG_INFO("Frame time p50 " << frameTimes.getPercentile(50.0) / 1e6 << " ms, p99 " << frameTimes.getPercentile(99.0) / 1e6
+             << " ms, max " << frameTimes.getMax() / 1e6 << " ms over " << frameTimes.getCount() << " frames");
+    if (frameStats.writeReport("data/logs/frame_stats.csv")) {
+        LOG_INFO("Frame stats saved to data/logs/frame_stats.csv");
     }
 
     // Terminate GLFW
     glfwTerminate();
+    Logger::instance().stop();
     return 0;
 }
\ No newline at end of file
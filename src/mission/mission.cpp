@@ -1,5 +1,11 @@
 #include "mission.h"
-#include <iostream>
+#include "logging/logger.h"
+#include "profiling/profiler.h"
+#include "sim/world_snapshot.h"
+
+namespace {
+const uint32_t kMissionSnapshotTag = makeSnapshotTag('M', 'I', 'S', 'N');
+}
 
 Mission::Mission() : currentRingIndex(0), missionComplete(false) {}
 
@@ -16,19 +22,26 @@ void Mission::init() {
     };
     currentRingIndex = 0;
     missionComplete = false;
-    std::cout << "Mission initialized with " << ringPositions.size() << " rings" << std::endl;
+    LOG_INFO("Mission initialized with " << ringPositions.size() << " rings");
+}
+
+void Mission::setRingPositions(const std::vector<glm::vec3>& positions) {
+    ringPositions = positions;
+    currentRingIndex = 0;
+    missionComplete = false;
 }
 
 void Mission::update(const glm::vec3& dronePos) {
+    PROFILE_SCOPE("Mission::update");
     if (missionComplete) return;
 
     if (checkRingCollision(dronePos, 0.5f)) {
         currentRingIndex++;
-        std::cout << "Ring " << currentRingIndex << " passed!" << std::endl;
+        LOG_INFO("Ring " << currentRingIndex << " passed!");
 
         if (currentRingIndex >= ringPositions.size()) {
             missionComplete = true;
-            std::cout << "Mission Complete!" << std::endl;
+            LOG_INFO("Mission Complete!");
         }
     }
 }
@@ -44,7 +57,7 @@ bool Mission::checkRingCollision(const glm::vec3& dronePos, float radius) {
 void Mission::reset() {
     currentRingIndex = 0;
     missionComplete = false;
-    std::cout << "Mission reset" << std::endl;
+    LOG_INFO("Mission reset");
 }
 
 int Mission::getCurrentRingIndex() {
@@ -59,6 +72,43 @@ bool Mission::isMissionComplete() {
     return missionComplete;
 }
 
-std::vector<glm::vec3> Mission::getRingPositions() {
+const std::vector<glm::vec3>& Mission::getRingPositions() const {
     return ringPositions;
+}
+
+void Mission::saveState(SnapshotWriter& writer) const {
+    writer.write(kMissionSnapshotTag);
+    writer.write((int)ringPositions.size());
+    writer.write(currentRingIndex);
+    writer.write((uint8_t)(missionComplete ? 1 : 0));
+}
+
+bool Mission::restoreState(SnapshotReader& reader) {
+    int ringIndex = 0;
+    bool complete = false;
+    if (!readState(reader, ringIndex, complete)) return false;
+    currentRingIndex = ringIndex;
+    missionComplete = complete;
+    return true;
+}
+
+bool Mission::checkState(SnapshotReader& reader) const {
+    int ringIndex = 0;
+    bool complete = false;
+    return readState(reader, ringIndex, complete);
+}
+
+bool Mission::readState(SnapshotReader& reader, int& ringIndex, bool& complete) const {
+    int totalRings = 0;
+    uint8_t completeFlag = 0;
+    if (!reader.expectTag(kMissionSnapshotTag) || !reader.read(totalRings) || !reader.read(ringIndex) || !reader.read(completeFlag)) {
+        LOG_ERROR("Invalid mission snapshot");
+        return false;
+    }
+    if (totalRings != (int)ringPositions.size() || ringIndex < 0 || ringIndex > totalRings) {
+        LOG_ERROR("Mission snapshot is for a course of " << totalRings << " rings, current course has " << ringPositions.size());
+        return false;
+    }
+    complete = completeFlag != 0;
+    return true;
 }
\ No newline at end of file
@@ -4,22 +4,34 @@
 #include <vector>
 #include <glm/glm.hpp>
 
+class SnapshotWriter;
+class SnapshotReader;
+
 class Mission {
 public:
     Mission();
     ~Mission();
     void init();
+    // Replaces the course (e.g. generated tracks) and restarts progress
+    void setRingPositions(const std::vector<glm::vec3>& positions);
     void update(const glm::vec3& dronePos);
     bool checkRingCollision(const glm::vec3& dronePos, float radius);
     void reset();
     int getCurrentRingIndex();
     int getTotalRings();
     bool isMissionComplete();
-    std::vector<glm::vec3> getRingPositions();
+    const std::vector<glm::vec3>& getRingPositions() const;
+    // Progress through the course; the course itself isn't stored and must match on restore
+    void saveState(SnapshotWriter& writer) const;
+    bool restoreState(SnapshotReader& reader);
+    // Reads and validates a saved section without applying it
+    bool checkState(SnapshotReader& reader) const;
 private:
     std::vector<glm::vec3> ringPositions;
     int currentRingIndex;
     bool missionComplete;
+
+    bool readState(SnapshotReader& reader, int& ringIndex, bool& complete) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "bullet_task_scheduler.h"
+
+#if defined(DRONE_BULLET_MT) && DRONE_BULLET_MT
+
+#include <algorithm>
+#include <mutex>
+#include "logging/logger.h"
+
+namespace {
+// ThreadPool::parallelFor isn't reentrant; a loop started from inside a loop body runs inline
+thread_local bool insideParallelLoop = false;
+
+struct ParallelLoopGuard {
+    bool wasInside;
+    ParallelLoopGuard() : wasInside(insideParallelLoop) { insideParallelLoop = true; }
+    ~ParallelLoopGuard() { insideParallelLoop = wasInside; }
+};
+}
+
+BulletTaskScheduler::BulletTaskScheduler(int numThreads) : btITaskScheduler("DroneThreadPool") {
+    setNumThreads(numThreads);
+}
+
+int BulletTaskScheduler::getMaxNumThreads() const {
+    // Bullet sizes its per-thread scratch arrays from this and indexes them with
+    // btGetCurrentThreadIndex(), which counts every thread that ever entered Bullet
+    return BT_MAX_THREAD_COUNT;
+}
+
+int BulletTaskScheduler::getNumThreads() const {
+    return (int)pool->getThreadCount();
+}
+
+void BulletTaskScheduler::setNumThreads(int numThreads) {
+    unsigned int threads = numThreads > 0 ? (unsigned int)std::min(numThreads, (int)BT_MAX_THREAD_COUNT) : 0;
+    pool.reset(); // Join the old workers before starting new ones
+    pool.reset(new ThreadPool(threads));
+}
+
+void BulletTaskScheduler::parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) {
+    if (iEnd <= iBegin) return;
+    if (insideParallelLoop) {
+        body.forLoop(iBegin, iEnd);
+        return;
+    }
+    ParallelLoopGuard guard;
+    pool->parallelFor(iEnd - iBegin, grainSize, [&](int begin, int end) {
+        ParallelLoopGuard workerGuard;
+        body.forLoop(iBegin + begin, iBegin + end);
+    });
+}
+
+btScalar BulletTaskScheduler::parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) {
+    if (iEnd <= iBegin) return btScalar(0);
+    if (insideParallelLoop) {
+        return body.sumLoop(iBegin, iEnd);
+    }
+    ParallelLoopGuard guard;
+    // Only used for the solver's residual, so summing chunks in completion order is fine
+    std::mutex sumMutex;
+    btScalar sum = btScalar(0);
+    pool->parallelFor(iEnd - iBegin, grainSize, [&](int begin, int end) {
+        ParallelLoopGuard workerGuard;
+        btScalar partial = body.sumLoop(iBegin + begin, iBegin + end);
+        std::lock_guard<std::mutex> lock(sumMutex);
+        sum += partial;
+    });
+    return sum;
+}
+
+BulletTaskScheduler* installBulletTaskScheduler(int numThreads) {
+    static std::mutex installMutex;
+    static std::unique_ptr<BulletTaskScheduler> scheduler;
+    std::lock_guard<std::mutex> lock(installMutex);
+    if (!scheduler) {
+        scheduler.reset(new BulletTaskScheduler(numThreads));
+        btSetTaskScheduler(scheduler.get());
+        LOG_INFO("Bullet task scheduler running on " << scheduler->getNumThreads() << " threads");
+    } else if (numThreads > 0 && numThreads != scheduler->getNumThreads()) {
+        LOG_WARN("Bullet task scheduler already running on " << scheduler->getNumThreads()
+                 << " threads; ignoring request for " << numThreads);
+    }
+    return scheduler.get();
+}
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef BULLET_TASK_SCHEDULER_H
+#define BULLET_TASK_SCHEDULER_H
+
+// Only built with -DDRONE_BULLET_MT=ON, which needs a Bullet compiled with BT_THREADSAFE
+#if defined(DRONE_BULLET_MT) && DRONE_BULLET_MT
+
+#include <LinearMath/btThreads.h>
+#include <memory>
+#include "sim/thread_pool.h"
+
+// Runs Bullet's parallel loops (collision dispatch, island solving, integration)
+// on our ThreadPool instead of Bullet's own worker threads. Bullet keeps a single
+// process-wide scheduler, so it is installed once through installBulletTaskScheduler.
+class BulletTaskScheduler : public btITaskScheduler {
+public:
+    explicit BulletTaskScheduler(int numThreads);
+
+    int getMaxNumThreads() const override;
+    int getNumThreads() const override;
+    void setNumThreads(int numThreads) override;
+    void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override;
+    btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override;
+private:
+    std::unique_ptr<ThreadPool> pool;
+};
+
+// Creates the scheduler on first use and hands it to Bullet; later calls keep the
+// first thread count because a running world may be mid-step on the old pool.
+// numThreads <= 0 uses every hardware thread.
+BulletTaskScheduler* installBulletTaskScheduler(int numThreads);
+
+#endif
+
+#endif
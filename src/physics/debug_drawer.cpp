@@ -1,24 +1,48 @@
 #include "debug_drawer.h"
-#include <iostream>
 #include <fstream>
-
-DebugDrawer::DebugDrawer() : debugMode(DBG_DrawWireframe) {
+#include <cstddef>
+#include "logging/logger.h"
+#include "profiling/profiler.h"
+
+DebugDrawer::DebugDrawer()
+    : VAO(0), VBO(0), partition(0), linesPerPartition(0), mapped(nullptr), lineCount(0), droppedLines(0),
+      staticVAO(0), staticVBO(0), recordingStatic(false), staticVertexCount(0), viewLoc(-1), projectionLoc(-1), debugMode(DBG_DrawWireframe) {
+    for (auto& fence : fences) {
+        fence = nullptr;
+    }
     createShaderProgram();
     createBuffers();
 }
 
 DebugDrawer::~DebugDrawer() {
+    if (mapped) {
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+    for (auto& fence : fences) {
+        if (fence) glDeleteSync(fence);
+    }
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
-    glDeleteProgram(shaderProgram);
+    glDeleteVertexArrays(1, &staticVAO);
+    glDeleteBuffers(1, &staticVBO);
 }
 
 void DebugDrawer::drawLine(const btVector3& from, const btVector3& to, const btVector3& color) {
-    lines.push_back({
-        glm::vec3(from.x(), from.y(), from.z()),
-        glm::vec3(to.x(), to.y(), to.z()),
-        glm::vec3(color.x(), color.y(), color.z())
-    });
+    if (recordingStatic) {
+        staticVertices.push_back({{from.x(), from.y(), from.z()}, {color.x(), color.y(), color.z()}});
+        staticVertices.push_back({{to.x(), to.y(), to.z()}, {color.x(), color.y(), color.z()}});
+        return;
+    }
+    if (!mapped || lineCount >= linesPerPartition) {
+        ++droppedLines;
+        return;
+    }
+
+    Vertex* v = mapped + lineCount * 2;
+    v[0] = {{from.x(), from.y(), from.z()}, {color.x(), color.y(), color.z()}};
+    v[1] = {{to.x(), to.y(), to.z()}, {color.x(), color.y(), color.z()}};
+    ++lineCount;
 }
 
 void DebugDrawer::drawContactPoint(const btVector3& PointOnB, const btVector3& normalOnB, btScalar distance, int lifeTime, const btVector3& color) {
@@ -28,7 +52,7 @@ void DebugDrawer::drawContactPoint(const btVector3& PointOnB, const btVector3& n
 }
 
 void DebugDrawer::reportErrorWarning(const char* warningString) {
-    std::cerr << "Bullet Physics Warning: " << warningString << std::endl;
+    LOG_WARN("Bullet Physics: " << warningString);
 }
 
 void DebugDrawer::draw3dText(const btVector3& location, const char* textString) {
@@ -43,47 +67,113 @@ int DebugDrawer::getDebugMode() const {
     return debugMode;
 }
 
-void DebugDrawer::render(const glm::mat4& view, const glm::mat4& projection) {
-    if (lines.empty()) return;
-
-    glUseProgram(shaderProgram);
-
-    // Set uniforms
-    GLuint viewLoc = glGetUniformLocation(shaderProgram, "view");
-    GLuint projLoc = glGetUniformLocation(shaderProgram, "projection");
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, &view[0][0]);
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, &projection[0][0]);
-
-    // Prepare vertex data
-    std::vector<float> vertices;
-    for (const auto& line : lines) {
-        // Start point
-        vertices.push_back(line.start.x);
-        vertices.push_back(line.start.y);
-        vertices.push_back(line.start.z);
-        vertices.push_back(line.color.r);
-        vertices.push_back(line.color.g);
-        vertices.push_back(line.color.b);
-
-        // End point
-        vertices.push_back(line.end.x);
-        vertices.push_back(line.end.y);
-        vertices.push_back(line.end.z);
-        vertices.push_back(line.color.r);
-        vertices.push_back(line.color.g);
-        vertices.push_back(line.color.b);
+void DebugDrawer::beginStaticLayer() {
+    staticVertices.clear();
+    recordingStatic = true;
+}
+
+void DebugDrawer::endStaticLayer() {
+    recordingStatic = false;
+    staticVertexCount = (int)staticVertices.size();
+
+    // Static bodies rarely change, so this upload happens a handful of times per run
+    glBindBuffer(GL_ARRAY_BUFFER, staticVBO);
+    glBufferData(GL_ARRAY_BUFFER, staticVertices.size() * sizeof(Vertex), staticVertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void DebugDrawer::beginFrame() {
+    if (mapped) return;
+
+    // Last frame overflowed: grow so the whole set fits from now on
+    int neededLines = lineCount + droppedLines;
+    if (neededLines > linesPerPartition) {
+        int lines = linesPerPartition;
+        while (lines < neededLines) {
+            lines *= 2;
+        }
+        LOG_WARN("Debug drawer dropped " << droppedLines << " lines, growing stream buffer to "
+                 << lines << " lines per frame");
+        allocateStreamBuffer(lines);
+    }
+    lineCount = 0;
+    droppedLines = 0;
+
+    // Wait until the GPU is done with the slice written three frames ago, then write without driver syncs
+    waitForPartition(partition);
+    GLintptr offset = (GLintptr)partition * linesPerPartition * 2 * sizeof(Vertex);
+    GLsizeiptr size = (GLsizeiptr)linesPerPartition * 2 * sizeof(Vertex);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    mapped = (Vertex*)glMapBufferRange(GL_ARRAY_BUFFER, offset, size,
+                                       GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT |
+                                       GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (!mapped) {
+        LOG_ERROR("Failed to map debug line buffer");
     }
+}
+
+void DebugDrawer::render(const glm::mat4& view, const glm::mat4& projection) {
+    PROFILE_SCOPE("DebugDrawer::render");
+    if (!mapped) return;
 
-    // Update VBO
-    glBindVertexArray(VAO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_DYNAMIC_DRAW);
+    if (lineCount > 0) {
+        glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)lineCount * 2 * sizeof(Vertex));
+    }
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    mapped = nullptr;
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    // Draw lines
-    glDrawArrays(GL_LINES, 0, lines.size() * 2);
+    if (lineCount > 0 || staticVertexCount > 0) {
+        shader.use();
 
-    // Clear lines for next frame
-    lines.clear();
+        // Set uniforms
+        glUniformMatrix4fv(viewLoc, 1, GL_FALSE, &view[0][0]);
+        glUniformMatrix4fv(projectionLoc, 1, GL_FALSE, &projection[0][0]);
+    }
+
+    // Cached static bodies
+    if (staticVertexCount > 0) {
+        glBindVertexArray(staticVAO);
+        glDrawArrays(GL_LINES, 0, staticVertexCount);
+    }
+
+    // Dynamic bodies from this frame's slice
+    if (lineCount > 0) {
+        glBindVertexArray(VAO);
+        glDrawArrays(GL_LINES, partition * linesPerPartition * 2, lineCount * 2);
+        fences[partition] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    glBindVertexArray(0);
+
+    partition = (partition + 1) % kPartitions;
+}
+
+void DebugDrawer::waitForPartition(int index) {
+    GLsync fence = fences[index];
+    if (!fence) return;
+
+    GLenum status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    while (status == GL_TIMEOUT_EXPIRED) {
+        status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    }
+    glDeleteSync(fence);
+    fences[index] = nullptr;
+}
+
+void DebugDrawer::allocateStreamBuffer(int lines) {
+    // Respecifying the store orphans the old one, so in-flight draws keep their data and old fences can go
+    for (auto& fence : fences) {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+    linesPerPartition = lines;
+    partition = 0;
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)kPartitions * lines * 2 * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void DebugDrawer::createShaderProgram() {
@@ -113,42 +203,39 @@ void DebugDrawer::createShaderProgram() {
         }
     )";
 
-    // Create vertex shader
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-
-    // Create fragment shader
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-
-    // Create program
-    shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
+    if (!shader.build(vertexShaderSource, fragmentShaderSource, "debug_drawer")) {
+        LOG_ERROR("Failed to create debug drawer shader");
+        return;
+    }
 
-    // Clean up
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    // Resolve uniform locations once instead of every frame
+    viewLoc = shader.getUniformLocation("view");
+    projectionLoc = shader.getUniformLocation("projection");
 }
 
 void DebugDrawer::createBuffers() {
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
+    glGenVertexArrays(1, &staticVAO);
+    glGenBuffers(1, &staticVBO);
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    allocateStreamBuffer(kInitialLinesPerPartition);
+    setupVertexLayout(VAO, VBO);
+    setupVertexLayout(staticVAO, staticVBO);
+}
+
+void DebugDrawer::setupVertexLayout(GLuint vao, GLuint vbo) {
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
     // Position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
     glEnableVertexAttribArray(0);
 
     // Color attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
     glEnableVertexAttribArray(1);
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
-}
\ No newline at end of file
+}
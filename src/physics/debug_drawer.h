@@ -6,8 +6,10 @@
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <vector>
+#include "renderer/shader_program.h"
+#include "physics.h"
 
-class DebugDrawer : public btIDebugDraw {
+class DebugDrawer : public btIDebugDraw, public StaticDebugLayer {
 public:
     DebugDrawer();
     ~DebugDrawer();
@@ -19,22 +21,51 @@ public:
     void setDebugMode(int debugMode) override;
     int getDebugMode() const override;
 
+    // Lines drawn in between go to a cached buffer that is redrawn every frame until the next rebuild
+    void beginStaticLayer() override;
+    void endStaticLayer() override;
+
+    // Map this frame's slice of the stream buffer; drawLine writes straight into it until render
+    void beginFrame();
     void render(const glm::mat4& view, const glm::mat4& projection);
 
+    int getLineCount() const { return lineCount; }
+    int getStaticLineCount() const { return staticVertexCount / 2; }
+    int getDroppedLines() const { return droppedLines; }
+
 private:
-    struct Line {
-        glm::vec3 start;
-        glm::vec3 end;
-        glm::vec3 color;
+    struct Vertex {
+        float position[3];
+        float color[3];
     };
 
-    std::vector<Line> lines;
+    // The stream buffer holds kPartitions slices so the CPU fills one while the GPU reads the others
+    static const int kPartitions = 3;
+    static const int kInitialLinesPerPartition = 4096;
+
     GLuint VAO, VBO;
-    GLuint shaderProgram;
+    GLsync fences[kPartitions];
+    int partition;
+    int linesPerPartition;
+    Vertex* mapped;
+    int lineCount;
+    int droppedLines;
+
+    GLuint staticVAO, staticVBO;
+    std::vector<Vertex> staticVertices;
+    bool recordingStatic;
+    int staticVertexCount;
+
+    ShaderProgram shader;
+    GLint viewLoc;
+    GLint projectionLoc;
     int debugMode;
 
     void createShaderProgram();
     void createBuffers();
+    void setupVertexLayout(GLuint vao, GLuint vbo);
+    void allocateStreamBuffer(int lines);
+    void waitForPartition(int index);
 };
 
 #endif
\ No newline at end of file
@@ -1,19 +1,87 @@
 #include "physics.h"
-#include <iostream>
+#include <algorithm>
+#include <new>
+#include "logging/logger.h"
+#include "profiling/profiler.h"
+#include "sim/world_snapshot.h"
+#if defined(DRONE_BULLET_MT) && DRONE_BULLET_MT
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include "bullet_task_scheduler.h"
+#endif
 
-Physics::Physics() : debugDrawer(nullptr) {}
+// Dynamic state of one live drone body. Bullet's vector types aren't trivially
+// copyable, so components are stored as plain scalars and copied back exactly.
+struct Physics::DroneBodyRecord {
+    btScalar transform[12]; // Basis rows, then origin
+    btScalar interpolationTransform[12];
+    btScalar linearVelocity[3];
+    btScalar angularVelocity[3];
+    btScalar interpolationLinearVelocity[3];
+    btScalar interpolationAngularVelocity[3];
+    btScalar totalForce[3];
+    btScalar totalTorque[3];
+    btScalar deactivationTime;
+    int activationState;
+    float spawnPosition[3];
+};
+
+namespace {
+
+const uint32_t kPhysicsSnapshotTag = makeSnapshotTag('P', 'H', 'Y', 'S');
+
+void storeVector(const btVector3& v, btScalar* out) {
+    out[0] = v.x();
+    out[1] = v.y();
+    out[2] = v.z();
+}
+
+btVector3 loadVector(const btScalar* in) {
+    return btVector3(in[0], in[1], in[2]);
+}
+
+void storeTransform(const btTransform& transform, btScalar* out) {
+    const btMatrix3x3& basis = transform.getBasis();
+    for (int row = 0; row < 3; ++row) {
+        storeVector(basis[row], out + 3 * row);
+    }
+    storeVector(transform.getOrigin(), out + 9);
+}
+
+btTransform loadTransform(const btScalar* in) {
+    btTransform transform;
+    transform.getBasis().setValue(in[0], in[1], in[2], in[3], in[4], in[5], in[6], in[7], in[8]);
+    transform.setOrigin(loadVector(in + 9));
+    return transform;
+}
+
+}
+
+Physics::Physics()
+    : collisionConfiguration(nullptr), dispatcher(nullptr), overlappingPairCache(nullptr), solver(nullptr),
+      solverPool(nullptr), dynamicsWorld(nullptr), droneBodies(nullptr), maxDrones(0), activeDrones(0), primaryDrone(kInvalidDrone),
+      groundBody(nullptr), ringBody(nullptr), groundShape(nullptr), droneShape(nullptr), ringShape(nullptr),
+      groundMotionState(nullptr), ringMotionState(nullptr),
+      debugDrawer(nullptr), staticDebugLayer(nullptr), staticGeometryRevision(1), staticLayerRevision(0),
+      staticLayerMode(0), deterministic(false) {}
 
 Physics::~Physics() {
     if (dynamicsWorld) {
         // Remove rigid bodies from world before deleting
         if (groundBody) dynamicsWorld->removeRigidBody(groundBody);
-        if (droneBody) dynamicsWorld->removeRigidBody(droneBody);
+        for (DroneId drone = 0; drone < maxDrones; ++drone) {
+            if (droneActive[drone]) dynamicsWorld->removeRigidBody(&droneBodies[drone]);
+        }
         if (ringBody) dynamicsWorld->removeRigidBody(ringBody);
         delete dynamicsWorld;
     }
     if (solver) {
         delete solver;
     }
+    if (solverPool) {
+        delete solverPool;
+    }
     if (overlappingPairCache) {
         delete overlappingPairCache;
     }
@@ -25,7 +93,12 @@ Physics::~Physics() {
     }
     // Delete rigid bodies
     if (groundBody) delete groundBody;
-    if (droneBody) delete droneBody;
+    if (droneBodies) {
+        for (int i = 0; i < maxDrones; ++i) {
+            droneBodies[i].~btRigidBody();
+        }
+        btAlignedFree(droneBodies);
+    }
     if (ringBody) delete ringBody;
     // Delete shapes
     if (groundShape) delete groundShape;
@@ -33,24 +106,42 @@ Physics::~Physics() {
     if (ringShape) delete ringShape;
     // Delete motion states
     if (groundMotionState) delete groundMotionState;
-    if (droneMotionState) delete droneMotionState;
     if (ringMotionState) delete ringMotionState;
 }
 
-bool Physics::init() {
+bool Physics::init(int maxDrones, int workerThreads) {
     try {
-    collisionConfiguration = new btDefaultCollisionConfiguration();
-    dispatcher = new btCollisionDispatcher(collisionConfiguration);
-    overlappingPairCache = new btDbvtBroadphase();
-    solver = new btSequentialImpulseConstraintSolver();
-    dynamicsWorld = new btDiscreteDynamicsWorld(dispatcher, overlappingPairCache, solver, collisionConfiguration);
+#if defined(DRONE_BULLET_MT) && DRONE_BULLET_MT
+    if (workerThreads != 0) {
+        // The scheduler has to be installed before the Mt dispatcher sizes its per-thread arrays
+        BulletTaskScheduler* scheduler = installBulletTaskScheduler(workerThreads);
+        // Manifolds and algorithms are allocated from worker threads; presize the pools so they don't overflow to the heap
+        btDefaultCollisionConstructionInfo constructionInfo;
+        constructionInfo.m_defaultMaxPersistentManifoldPoolSize = 80000;
+        constructionInfo.m_defaultMaxCollisionAlgorithmPoolSize = 80000;
+        collisionConfiguration = new btDefaultCollisionConfiguration(constructionInfo);
+        dispatcher = new btCollisionDispatcherMt(collisionConfiguration, 40);
+        overlappingPairCache = new btDbvtBroadphase();
+        // Islands are solved in parallel, one pooled solver per thread; big islands use the Mt solver
+        btConstraintSolverPoolMt* pool = new btConstraintSolverPoolMt(scheduler->getNumThreads());
+        solverPool = pool;
+        solver = new btSequentialImpulseConstraintSolverMt();
+        dynamicsWorld = new btDiscreteDynamicsWorldMt(dispatcher, overlappingPairCache, pool, solver, collisionConfiguration);
+    }
+#else
+    if (workerThreads != 0) {
+        LOG_WARN("Multithreaded physics requested but not compiled in; reconfigure with -DDRONE_BULLET_MT=ON");
+    }
+#endif
+    if (!dynamicsWorld) {
+        collisionConfiguration = new btDefaultCollisionConfiguration();
+        dispatcher = new btCollisionDispatcher(collisionConfiguration);
+        overlappingPairCache = new btDbvtBroadphase();
+        solver = new btSequentialImpulseConstraintSolver();
+        dynamicsWorld = new btDiscreteDynamicsWorld(dispatcher, overlappingPairCache, solver, collisionConfiguration);
+    }
     dynamicsWorld->setGravity(btVector3(0, -9.81, 0));
 
-    // Initialize debug drawer
-    debugDrawer = new DebugDrawer();
-    dynamicsWorld->setDebugDrawer(debugDrawer);
-    debugDrawer->setDebugMode(btIDebugDraw::DBG_DrawWireframe | btIDebugDraw::DBG_DrawAabb);
-
     // Create ground
     groundShape = new btStaticPlaneShape(btVector3(0, 1, 0), 0);
     groundMotionState = new btDefaultMotionState(btTransform(btQuaternion(0, 0, 0, 1), btVector3(0, 0, 0)));
@@ -58,15 +149,27 @@ bool Physics::init() {
     groundBody = new btRigidBody(groundRigidBodyCI);
     dynamicsWorld->addRigidBody(groundBody);
 
-    // Create drone - spherical shape for smooth collision
+    // Drone pool - spherical shape for smooth collision, shared by every drone.
+    // Bodies have no motion state: positions are read straight from the body, and
+    // with fixed ticks there is nothing for Bullet to interpolate anyway.
     droneShape = new btSphereShape(0.3f);
-    droneMotionState = new btDefaultMotionState(btTransform(btQuaternion(0, 0, 0, 1), btVector3(0, 5, 0)));
     btScalar mass = 1;
     btVector3 droneInertia(0, 0, 0);
     droneShape->calculateLocalInertia(mass, droneInertia);
-    btRigidBody::btRigidBodyConstructionInfo droneRigidBodyCI(mass, droneMotionState, droneShape, droneInertia);
-    droneBody = new btRigidBody(droneRigidBodyCI);
-    dynamicsWorld->addRigidBody(droneBody);
+    btRigidBody::btRigidBodyConstructionInfo droneRigidBodyCI(mass, nullptr, droneShape, droneInertia);
+    this->maxDrones = std::max(maxDrones, 1);
+    droneBodies = static_cast<btRigidBody*>(btAlignedAlloc(sizeof(btRigidBody) * this->maxDrones, 16));
+    for (int i = 0; i < this->maxDrones; ++i) {
+        new (&droneBodies[i]) btRigidBody(droneRigidBodyCI);
+        droneBodies[i].setUserIndex(i);
+    }
+    droneActive.assign(this->maxDrones, 0);
+    droneSpawnPositions.assign(this->maxDrones, glm::vec3(0.0f));
+    freeDrones.clear();
+    for (int i = this->maxDrones - 1; i >= 0; --i) {
+        freeDrones.push_back(i); // Lowest slots are handed out first
+    }
+    primaryDrone = spawnDrone(glm::vec3(0.0f, 5.0f, 0.0f));
 
     // Create ring
     ringShape = new btCylinderShape(btVector3(1, 0.1, 1));
@@ -75,10 +178,10 @@ bool Physics::init() {
     ringBody = new btRigidBody(ringRigidBodyCI);
     dynamicsWorld->addRigidBody(ringBody);
 
-    std::cout << "Physics initialized successfully" << std::endl;
+    LOG_INFO("Physics initialized successfully" << (isMultithreaded() ? " (multithreaded world)" : ""));
     return true;
     } catch (const std::exception& e) {
-        std::cerr << "ERROR: Failed to initialize physics: " << e.what() << std::endl;
+        LOG_ERROR("Failed to initialize physics: " << e.what());
         return false;
     }
 }
@@ -87,24 +190,316 @@ void Physics::step(float deltaTime) {
     dynamicsWorld->stepSimulation(deltaTime, 10);
 }
 
+void Physics::stepFixed(float tickSeconds) {
+    PROFILE_SCOPE("Physics::stepFixed");
+    // maxSubSteps = 0 makes Bullet take exactly one step of the given size
+    dynamicsWorld->stepSimulation(tickSeconds, 0);
+}
+
+DroneId Physics::spawnDrone(const glm::vec3& position) {
+    if (freeDrones.empty()) {
+        LOG_WARN("Drone pool exhausted (" << maxDrones << " drones)");
+        return kInvalidDrone;
+    }
+    DroneId drone = freeDrones.back();
+    freeDrones.pop_back();
+
+    droneSpawnPositions[drone] = position;
+    droneActive[drone] = 1;
+    ++activeDrones;
+    resetDrone(drone);
+    dynamicsWorld->addRigidBody(&droneBodies[drone]);
+    return drone;
+}
+
+void Physics::despawnDrone(DroneId drone) {
+    if (!isDroneActive(drone)) return;
+    if (drone == primaryDrone) {
+        LOG_WARN("The primary drone can't be despawned");
+        return;
+    }
+    dynamicsWorld->removeRigidBody(&droneBodies[drone]);
+    droneActive[drone] = 0;
+    --activeDrones;
+    freeDrones.push_back(drone);
+}
+
+bool Physics::isDroneActive(DroneId drone) const {
+    return drone >= 0 && drone < maxDrones && droneActive[drone];
+}
+
+btRigidBody* Physics::getDroneBody(DroneId drone) {
+    return isDroneActive(drone) ? &droneBodies[drone] : nullptr;
+}
+
+void Physics::applyThrust(DroneId drone, const glm::vec3& force) {
+    if (!isDroneActive(drone)) return;
+    btRigidBody& body = droneBodies[drone];
+    if (force != glm::vec3(0.0f)) {
+        body.activate(); // Forces on a sleeping body are ignored
+    }
+    body.applyCentralForce(btVector3(force.x, force.y, force.z));
+}
+
+glm::vec3 Physics::getDronePosition(DroneId drone) const {
+    if (!isDroneActive(drone)) return glm::vec3(0.0f);
+    const btVector3& pos = droneBodies[drone].getWorldTransform().getOrigin();
+    return glm::vec3(pos.getX(), pos.getY(), pos.getZ());
+}
+
+glm::vec3 Physics::getDroneVelocity(DroneId drone) const {
+    if (!isDroneActive(drone)) return glm::vec3(0.0f);
+    const btVector3& vel = droneBodies[drone].getLinearVelocity();
+    return glm::vec3(vel.getX(), vel.getY(), vel.getZ());
+}
+
+glm::quat Physics::getDroneOrientation(DroneId drone) const {
+    if (!isDroneActive(drone)) return glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    btQuaternion rot = droneBodies[drone].getWorldTransform().getRotation();
+    return glm::quat(rot.getW(), rot.getX(), rot.getY(), rot.getZ());
+}
+
+void Physics::resetDrone(DroneId drone) {
+    if (!isDroneActive(drone)) return;
+    btRigidBody& body = droneBodies[drone];
+    const glm::vec3& spawn = droneSpawnPositions[drone];
+    btTransform startTransform(btQuaternion(0, 0, 0, 1), btVector3(spawn.x, spawn.y, spawn.z));
+    body.setLinearVelocity(btVector3(0, 0, 0));
+    body.setAngularVelocity(btVector3(0, 0, 0));
+    body.clearForces();
+    body.setWorldTransform(startTransform);
+    // Keep the interpolated transform in sync so position reads see the reset immediately
+    body.setInterpolationWorldTransform(startTransform);
+    body.setInterpolationLinearVelocity(btVector3(0, 0, 0));
+    body.setInterpolationAngularVelocity(btVector3(0, 0, 0));
+    body.activate(true);
+}
+
+int Physics::exportDroneStates(const DroneStateBuffers& out) const {
+    PROFILE_SCOPE("Physics::exportDroneStates");
+    int count = 0;
+    for (DroneId drone = 0; drone < maxDrones; ++drone) {
+        if (out.active) out.active[drone] = droneActive[drone];
+        if (!droneActive[drone]) continue;
+        ++count;
+
+        const btRigidBody& body = droneBodies[drone];
+        const btTransform& transform = body.getWorldTransform();
+        if (out.positions) {
+            const btVector3& origin = transform.getOrigin();
+            float* position = out.positions + 3 * drone;
+            position[0] = origin.x();
+            position[1] = origin.y();
+            position[2] = origin.z();
+        }
+        if (out.orientations) {
+            btQuaternion rotation = transform.getRotation();
+            float* orientation = out.orientations + 4 * drone;
+            orientation[0] = rotation.x();
+            orientation[1] = rotation.y();
+            orientation[2] = rotation.z();
+            orientation[3] = rotation.w();
+        }
+        if (out.linearVelocities) {
+            const btVector3& velocity = body.getLinearVelocity();
+            float* linear = out.linearVelocities + 3 * drone;
+            linear[0] = velocity.x();
+            linear[1] = velocity.y();
+            linear[2] = velocity.z();
+        }
+        if (out.angularVelocities) {
+            const btVector3& velocity = body.getAngularVelocity();
+            float* angular = out.angularVelocities + 3 * drone;
+            angular[0] = velocity.x();
+            angular[1] = velocity.y();
+            angular[2] = velocity.z();
+        }
+    }
+    return count;
+}
+
+void Physics::applyForces(const float* forces) {
+    PROFILE_SCOPE("Physics::applyForces");
+    for (DroneId drone = 0; drone < maxDrones; ++drone) {
+        const float* force = forces + 3 * drone;
+        if (!droneActive[drone] || (force[0] == 0.0f && force[1] == 0.0f && force[2] == 0.0f)) continue;
+        btRigidBody& body = droneBodies[drone];
+        body.activate();
+        body.applyCentralForce(btVector3(force[0], force[1], force[2]));
+    }
+}
+
+void Physics::saveState(SnapshotWriter& writer) const {
+    PROFILE_SCOPE("Physics::saveState");
+    writer.write(kPhysicsSnapshotTag);
+    writer.write(maxDrones);
+    writer.write(activeDrones);
+    writer.writeArray(droneActive.data(), droneActive.size());
+    // The free list order decides which slots later spawns get
+    int freeCount = (int)freeDrones.size();
+    writer.write(freeCount);
+    writer.writeArray(freeDrones.data(), freeDrones.size());
+
+    DroneBodyRecord record;
+    for (DroneId drone = 0; drone < maxDrones; ++drone) {
+        if (!droneActive[drone]) continue;
+        const btRigidBody& body = droneBodies[drone];
+        storeTransform(body.getWorldTransform(), record.transform);
+        storeTransform(body.getInterpolationWorldTransform(), record.interpolationTransform);
+        storeVector(body.getLinearVelocity(), record.linearVelocity);
+        storeVector(body.getAngularVelocity(), record.angularVelocity);
+        storeVector(body.getInterpolationLinearVelocity(), record.interpolationLinearVelocity);
+        storeVector(body.getInterpolationAngularVelocity(), record.interpolationAngularVelocity);
+        storeVector(body.getTotalForce(), record.totalForce);
+        storeVector(body.getTotalTorque(), record.totalTorque);
+        record.deactivationTime = body.getDeactivationTime();
+        record.activationState = body.getActivationState();
+        const glm::vec3& spawn = droneSpawnPositions[drone];
+        record.spawnPosition[0] = spawn.x;
+        record.spawnPosition[1] = spawn.y;
+        record.spawnPosition[2] = spawn.z;
+        writer.write(record);
+    }
+}
+
+bool Physics::restoreState(SnapshotReader& reader) {
+    PROFILE_SCOPE("Physics::restoreState");
+    // Validate everything up front so a bad snapshot leaves the world untouched
+    int savedMaxDrones = 0;
+    int savedActiveDrones = 0;
+    int freeCount = 0;
+    if (!reader.expectTag(kPhysicsSnapshotTag) || !reader.read(savedMaxDrones)) {
+        LOG_ERROR("Invalid physics snapshot");
+        return false;
+    }
+    if (savedMaxDrones != maxDrones) {
+        LOG_ERROR("Physics snapshot holds " << savedMaxDrones << " drone slots, world has " << maxDrones);
+        return false;
+    }
+    restoreActive.resize(maxDrones);
+    if (!reader.read(savedActiveDrones) || !reader.readArray(restoreActive.data(), restoreActive.size()) ||
+        !reader.read(freeCount) || freeCount < 0 || freeCount > maxDrones) {
+        LOG_ERROR("Truncated physics snapshot");
+        return false;
+    }
+    restoreFreeDrones.resize(freeCount);
+    if (!reader.readArray(restoreFreeDrones.data(), restoreFreeDrones.size())) {
+        LOG_ERROR("Truncated physics snapshot");
+        return false;
+    }
+
+    // The live slots and the free list must partition the pool exactly
+    int flaggedActive = 0;
+    for (uint8_t& active : restoreActive) {
+        active = active ? 1 : 0;
+        flaggedActive += active;
+    }
+    bool freeListValid = flaggedActive == savedActiveDrones && savedActiveDrones + freeCount == maxDrones &&
+                         restoreActive[primaryDrone];
+    for (int i = 0; i < freeCount && freeListValid; ++i) {
+        DroneId drone = restoreFreeDrones[i];
+        // Free slots are marked 2 while checking so duplicates show up, then cleared again below
+        freeListValid = drone >= 0 && drone < maxDrones && restoreActive[drone] == 0;
+        if (freeListValid) restoreActive[drone] = 2;
+    }
+    for (DroneId drone : restoreFreeDrones) {
+        if (drone >= 0 && drone < maxDrones && restoreActive[drone] == 2) restoreActive[drone] = 0;
+    }
+    if (!freeListValid) {
+        LOG_ERROR("Corrupt physics snapshot: drone slot table is inconsistent");
+        return false;
+    }
+
+    restoreRecords.resize(savedActiveDrones);
+    if (!reader.readArray(restoreRecords.data(), restoreRecords.size())) {
+        LOG_ERROR("Truncated physics snapshot");
+        return false;
+    }
+
+    // Bodies that are live now but weren't at save time leave the world first
+    for (DroneId drone = 0; drone < maxDrones; ++drone) {
+        if (droneActive[drone] && !restoreActive[drone]) {
+            dynamicsWorld->removeRigidBody(&droneBodies[drone]);
+        }
+    }
+
+    // Nothing below can fail: records were read and counted against the live slots above
+    size_t nextRecord = 0;
+    for (DroneId drone = 0; drone < maxDrones; ++drone) {
+        if (!restoreActive[drone]) continue;
+        const DroneBodyRecord& record = restoreRecords[nextRecord++];
+        btRigidBody& body = droneBodies[drone];
+        body.setWorldTransform(loadTransform(record.transform));
+        body.setInterpolationWorldTransform(loadTransform(record.interpolationTransform));
+        body.setLinearVelocity(loadVector(record.linearVelocity));
+        body.setAngularVelocity(loadVector(record.angularVelocity));
+        body.setInterpolationLinearVelocity(loadVector(record.interpolationLinearVelocity));
+        body.setInterpolationAngularVelocity(loadVector(record.interpolationAngularVelocity));
+        body.clearForces();
+        body.applyCentralForce(loadVector(record.totalForce));
+        body.applyTorque(loadVector(record.totalTorque));
+        body.forceActivationState(record.activationState);
+        body.setDeactivationTime(record.deactivationTime);
+        body.updateInertiaTensor();
+        droneSpawnPositions[drone] = glm::vec3(record.spawnPosition[0], record.spawnPosition[1], record.spawnPosition[2]);
+
+        if (droneActive[drone]) {
+            // A new proxy drops the body's pairs and manifolds and finds its current overlaps again
+            dynamicsWorld->refreshBroadphaseProxy(&body);
+        } else {
+            dynamicsWorld->addRigidBody(&body);
+        }
+    }
+
+    droneActive.swap(restoreActive);
+    freeDrones.swap(restoreFreeDrones);
+    activeDrones = savedActiveDrones;
+    // Restarts the solver's random order so a restored world steps like the saved one
+    resetSolver();
+    return true;
+}
+
+bool Physics::setDeterministic(bool enabled) {
+    if (enabled && isMultithreaded()) {
+        LOG_WARN("Deterministic mode needs the single-threaded physics world");
+        return false;
+    }
+    deterministic = enabled;
+    dynamicsWorld->getDispatchInfo().m_deterministicOverlappingPairs = enabled;
+    resetSolver();
+    return true;
+}
+
+void Physics::resetSolver() {
+    solver->reset();
+    if (solverPool) {
+        solverPool->reset();
+    }
+    if (deterministic) {
+        // Only the single-threaded world can be deterministic, so this is always the plain solver.
+        // The RNG only shuffles constraints when Bullet is built with SOLVER_RANDMIZE_ORDER.
+        static_cast<btSequentialImpulseConstraintSolver*>(solver)->setRandSeed(0);
+    }
+}
+
 btRigidBody* Physics::getDroneBody() {
-    return droneBody;
+    return getDroneBody(primaryDrone);
 }
 
 void Physics::applyThrust(const glm::vec3& force) {
-    droneBody->applyCentralForce(btVector3(force.x, force.y, force.z));
+    applyThrust(primaryDrone, force);
 }
 
 glm::vec3 Physics::getDronePosition() {
-    btTransform trans;
-    droneBody->getMotionState()->getWorldTransform(trans);
-    btVector3 pos = trans.getOrigin();
-    return glm::vec3(pos.getX(), pos.getY(), pos.getZ());
+    return getDronePosition(primaryDrone);
 }
 
 glm::vec3 Physics::getDroneVelocity() {
-    btVector3 vel = droneBody->getLinearVelocity();
-    return glm::vec3(vel.getX(), vel.getY(), vel.getZ());
+    return getDroneVelocity(primaryDrone);
+}
+
+glm::quat Physics::getDroneOrientation() {
+    return getDroneOrientation(primaryDrone);
 }
 
 glm::vec3 Physics::getRingPosition() {
@@ -115,15 +510,91 @@ glm::vec3 Physics::getRingPosition() {
 }
 
 void Physics::resetDrone() {
-    droneBody->setLinearVelocity(btVector3(0, 0, 0));
-    droneBody->setAngularVelocity(btVector3(0, 0, 0));
-    droneBody->setWorldTransform(btTransform(btQuaternion(0, 0, 0, 1), btVector3(0, 5, 0)));
+    resetDrone(primaryDrone);
+}
+
+void Physics::setDebugDrawer(btIDebugDraw* drawer, StaticDebugLayer* staticLayer) {
+    // The drawer is owned by the caller so the physics world stays free of any GL dependency
+    debugDrawer = drawer;
+    staticDebugLayer = drawer ? staticLayer : nullptr;
+    staticLayerRevision = 0;
+    dynamicsWorld->setDebugDrawer(debugDrawer);
+    // Start with drawing off: while it's on, the render thread locks the world every frame (F1 turns it on)
+    if (debugDrawer) {
+        debugDrawer->setDebugMode(0);
+    }
+}
+
+void Physics::markStaticGeometryChanged() {
+    ++staticGeometryRevision;
 }
 
-void Physics::renderDebug(const glm::mat4& view, const glm::mat4& projection) {
-    if (debugDrawer && dynamicsWorld) {
+void Physics::debugDrawWorld(const VisibilityTest& isVisible) {
+    PROFILE_SCOPE("Physics::debugDrawWorld");
+    if (!debugDrawer || !dynamicsWorld) return;
+
+    // Nothing to traverse when drawing is switched off
+    int mode = debugDrawer->getDebugMode();
+    if (mode == 0) return;
+
+    if (!isVisible && !staticDebugLayer) {
         dynamicsWorld->debugDrawWorld();
-        debugDrawer->render(view, projection);
+        return;
+    }
+
+    // Same per-object output as btCollisionWorld::debugDrawWorld, but only for objects in view
+    btIDebugDraw::DefaultColors colors = debugDrawer->getDefaultColors();
+    const btCollisionObjectArray& objects = dynamicsWorld->getCollisionObjectArray();
+
+    // Static bodies are traced once into the drawer's cached layer, and again only when they change
+    if (staticDebugLayer && (staticLayerRevision != staticGeometryRevision || staticLayerMode != mode)) {
+        staticDebugLayer->beginStaticLayer();
+        for (int i = 0; i < objects.size(); ++i) {
+            const btCollisionObject* object = objects[i];
+            if (!object->isStaticObject()) continue;
+            if (object->getCollisionFlags() & btCollisionObject::CF_DISABLE_VISUALIZE_OBJECT) continue;
+
+            btVector3 aabbMin, aabbMax;
+            object->getCollisionShape()->getAabb(object->getWorldTransform(), aabbMin, aabbMax);
+            debugDrawObject(object, aabbMin, aabbMax, mode, colors);
+        }
+        staticDebugLayer->endStaticLayer();
+        staticLayerRevision = staticGeometryRevision;
+        staticLayerMode = mode;
+    }
+
+    for (int i = 0; i < objects.size(); ++i) {
+        const btCollisionObject* object = objects[i];
+        if (staticDebugLayer && object->isStaticObject()) continue;
+        if (object->getCollisionFlags() & btCollisionObject::CF_DISABLE_VISUALIZE_OBJECT) continue;
+
+        btVector3 aabbMin, aabbMax;
+        object->getCollisionShape()->getAabb(object->getWorldTransform(), aabbMin, aabbMax);
+        if (isVisible) {
+            btVector3 center = (aabbMin + aabbMax) * btScalar(0.5);
+            float radius = (aabbMax - aabbMin).length() * 0.5f;
+            if (!isVisible(glm::vec3(center.x(), center.y(), center.z()), radius)) continue;
+        }
+        debugDrawObject(object, aabbMin, aabbMax, mode, colors);
+    }
+}
+
+void Physics::debugDrawObject(const btCollisionObject* object, const btVector3& aabbMin, const btVector3& aabbMax,
+                              int mode, const btIDebugDraw::DefaultColors& colors) {
+    if (mode & btIDebugDraw::DBG_DrawWireframe) {
+        btVector3 color;
+        switch (object->getActivationState()) {
+            case ACTIVE_TAG: color = colors.m_activeObject; break;
+            case ISLAND_SLEEPING: color = colors.m_deactivatedObject; break;
+            case WANTS_DEACTIVATION: color = colors.m_wantsDeactivationObject; break;
+            case DISABLE_DEACTIVATION: color = colors.m_disabledDeactivationObject; break;
+            case DISABLE_SIMULATION: color = colors.m_disabledSimulationObject; break;
+            default: color = btVector3(1, 0, 0);
+        }
+        dynamicsWorld->debugDrawObject(object->getWorldTransform(), object->getCollisionShape(), color);
+    }
+    if (mode & btIDebugDraw::DBG_DrawAabb) {
+        debugDrawer->drawAabb(aabbMin, aabbMax, colors.m_aabb);
     }
 }
 
@@ -3,39 +3,146 @@
 
 #include <btBulletDynamicsCommon.h>
 #include <glm/glm.hpp>
-#include "debug_drawer.h"
+#include <glm/gtc/quaternion.hpp>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Optional drawer capability: lines emitted between beginStaticLayer and endStaticLayer
+// are kept and redrawn every frame until the layer is rebuilt
+class StaticDebugLayer {
+public:
+    virtual ~StaticDebugLayer() {}
+    virtual void beginStaticLayer() = 0;
+    virtual void endStaticLayer() = 0;
+};
+
+class SnapshotWriter;
+class SnapshotReader;
+
+// Slot of a drone in the physics pool; kInvalidDrone when spawning fails
+typedef int DroneId;
+static const DroneId kInvalidDrone = -1;
+
+// Caller-owned arrays filled by Physics::exportDroneStates, one per field and
+// indexed by DroneId, each sized for getMaxDrones() drones. Vector fields are
+// xyz interleaved, orientations xyzw. Null fields are skipped.
+struct DroneStateBuffers {
+    float* positions = nullptr;
+    float* orientations = nullptr;
+    float* linearVelocities = nullptr;
+    float* angularVelocities = nullptr;
+    uint8_t* active = nullptr;
+};
 
 class Physics {
 public:
+    // Bounding-sphere visibility test used to skip debug geometry outside the view
+    typedef std::function<bool(const glm::vec3& center, float radius)> VisibilityTest;
+
+    static const int kDefaultMaxDrones = 64;
+
     Physics();
     ~Physics();
-    bool init();
+    // Preallocates maxDrones drone bodies and spawns the primary drone. workerThreads > 0
+    // builds a btDiscreteDynamicsWorldMt stepped on that many threads (-1 for every core);
+    // without DRONE_BULLET_MT it falls back to the single-threaded world.
+    bool init(int maxDrones = kDefaultMaxDrones, int workerThreads = 0);
     void step(float deltaTime);
+    void stepFixed(float tickSeconds);
+
+    // Drone pool. Drones share one sphere shape and are stored in one contiguous
+    // block of rigid bodies; spawning only adds a prebuilt body to the world.
+    DroneId spawnDrone(const glm::vec3& position);
+    void despawnDrone(DroneId drone);
+    bool isDroneActive(DroneId drone) const;
+    int getDroneCount() const { return activeDrones; }
+    int getMaxDrones() const { return maxDrones; }
+    // Drone spawned by init and never despawned; the accessors without a DroneId act on it
+    DroneId getPrimaryDrone() const { return primaryDrone; }
+
+    // Ids that aren't active (e.g. kInvalidDrone from a full pool) are ignored: getters return
+    // zero vectors or the identity rotation and getDroneBody returns null
+    btRigidBody* getDroneBody(DroneId drone);
+    void applyThrust(DroneId drone, const glm::vec3& force);
+    glm::vec3 getDronePosition(DroneId drone) const;
+    glm::vec3 getDroneVelocity(DroneId drone) const;
+    glm::quat getDroneOrientation(DroneId drone) const;
+    // Teleports the drone back to where it was spawned and stops it
+    void resetDrone(DroneId drone);
+
+    // Bulk paths for many drones: one pass over the body block instead of a call per field per drone.
+    // Slots of inactive drones are left untouched (active[] is cleared for them). Returns the active count.
+    int exportDroneStates(const DroneStateBuffers& out) const;
+    // forces holds xyz per DroneId for getMaxDrones() drones; inactive slots and zero forces are skipped
+    void applyForces(const float* forces);
+
+    // Snapshot of the drone pool: which slots are live and every live body's transform,
+    // velocities, pending forces and sleep state. Static bodies never move and aren't stored.
+    // Restoring needs a world initialized with the same maxDrones and leaves it exactly as
+    // saved, except that contact manifolds, broadphase pairs and solver warm-start data are
+    // dropped and rebuilt on the next step. Bodies that were spawned or despawned since the
+    // save are re-added to the world, which changes their solver order.
+    void saveState(SnapshotWriter& writer) const;
+    bool restoreState(SnapshotReader& reader);
+
     btRigidBody* getDroneBody();
     void applyThrust(const glm::vec3& force);
     glm::vec3 getDronePosition();
     glm::vec3 getDroneVelocity();
+    glm::quat getDroneOrientation();
     glm::vec3 getRingPosition();
     void resetDrone();
-    void renderDebug(const glm::mat4& view, const glm::mat4& projection);
+    void setDebugDrawer(btIDebugDraw* drawer, StaticDebugLayer* staticLayer = nullptr);
+    void debugDrawWorld(const VisibilityTest& isVisible = VisibilityTest());
+    // Call after adding, removing or moving static bodies so the cached debug layer is rebuilt
+    void markStaticGeometryChanged();
     void toggleDebugMode();
     bool isDebugModeEnabled() const;
+    bool isMultithreaded() const { return solverPool != nullptr; }
+    // Deterministic mode: overlapping pairs are sorted before dispatch so contact order doesn't
+    // depend on broadphase history, and the solver's RNG is reset to a fixed seed (and again on restore).
+    // Not available for the multithreaded world, whose island order depends on thread timing.
+    bool setDeterministic(bool enabled);
+    bool isDeterministic() const { return deterministic; }
 private:
+    struct DroneBodyRecord;
+
     btDefaultCollisionConfiguration* collisionConfiguration;
     btCollisionDispatcher* dispatcher;
     btBroadphaseInterface* overlappingPairCache;
-    btSequentialImpulseConstraintSolver* solver;
+    btConstraintSolver* solver;
+    // btConstraintSolverPoolMt when multithreaded; solver is then the Mt solver used for large islands
+    btConstraintSolver* solverPool;
     btDiscreteDynamicsWorld* dynamicsWorld;
-    btRigidBody* droneBody;
+    btRigidBody* droneBodies;
+    int maxDrones;
+    int activeDrones;
+    DroneId primaryDrone;
+    std::vector<DroneId> freeDrones;
+    std::vector<uint8_t> droneActive;
+    std::vector<glm::vec3> droneSpawnPositions;
+    // Scratch for restoreState, kept to avoid allocating per restore
+    std::vector<uint8_t> restoreActive;
+    std::vector<DroneId> restoreFreeDrones;
+    std::vector<DroneBodyRecord> restoreRecords;
     btRigidBody* groundBody;
     btRigidBody* ringBody;
     btCollisionShape* groundShape;
     btCollisionShape* droneShape;
     btCollisionShape* ringShape;
     btMotionState* groundMotionState;
-    btMotionState* droneMotionState;
     btMotionState* ringMotionState;
-    DebugDrawer* debugDrawer;
+    btIDebugDraw* debugDrawer;
+    StaticDebugLayer* staticDebugLayer;
+    unsigned staticGeometryRevision;
+    unsigned staticLayerRevision;
+    int staticLayerMode;
+    bool deterministic;
+
+    void resetSolver();
+    void debugDrawObject(const btCollisionObject* object, const btVector3& aabbMin, const btVector3& aabbMax,
+                         int mode, const btIDebugDraw::DefaultColors& colors);
 };
 
 #endif
\ No newline at end of file
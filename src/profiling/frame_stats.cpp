@@ -0,0 +1,47 @@
+#include "frame_stats.h"
+#include <cstdio>
+#include "logging/logger.h"
+
+void FrameStats::recordFrame(uint64_t intervalNs) {
+    histograms[FRAME_STAGE_FRAME].record(intervalNs);
+    window.record(intervalNs);
+}
+
+const char* FrameStats::getStageName(FrameStage stage) {
+    switch (stage) {
+        case FRAME_STAGE_FRAME: return "frame";
+        case FRAME_STAGE_CPU: return "frame_cpu";
+        case FRAME_STAGE_CONTROLS: return "controls";
+        case FRAME_STAGE_LOGGING: return "logging";
+        case FRAME_STAGE_RENDER: return "render";
+        case FRAME_STAGE_DEBUG_DRAW: return "debug_draw";
+        case FRAME_STAGE_SWAP: return "swap";
+        case FRAME_STAGE_SIM_TICK: return "sim_tick";
+        case FRAME_STAGE_GPU_SCENE: return "gpu_scene";
+        case FRAME_STAGE_GPU_RINGS: return "gpu_rings";
+        case FRAME_STAGE_GPU_DEBUG_LINES: return "gpu_debug_lines";
+        default: return "unknown";
+    }
+}
+
+bool FrameStats::writeReport(const std::string& path) const {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("Failed to open frame stats file: " << path);
+        return false;
+    }
+
+    std::fputs("stage,count,mean_ms,p50_ms,p95_ms,p99_ms,p99_9_ms,max_ms\n", file);
+    for (int i = 0; i < FRAME_STAGE_COUNT; ++i) {
+        const LatencyHistogram& histogram = histograms[i];
+        std::fprintf(file, "%s,%llu,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n",
+                     getStageName((FrameStage)i), (unsigned long long)histogram.getCount(),
+                     histogram.getMean() / 1e6,
+                     histogram.getPercentile(50.0) / 1e6,
+                     histogram.getPercentile(95.0) / 1e6,
+                     histogram.getPercentile(99.0) / 1e6,
+                     histogram.getPercentile(99.9) / 1e6,
+                     histogram.getMax() / 1e6);
+    }
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,41 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <string>
+#include "latency_histogram.h"
+
+enum FrameStage {
+    FRAME_STAGE_FRAME = 0,   // Interval between frame starts
+    FRAME_STAGE_CPU,         // CPU work per frame, excluding the swap
+    FRAME_STAGE_CONTROLS,
+    FRAME_STAGE_LOGGING,
+    FRAME_STAGE_RENDER,
+    FRAME_STAGE_DEBUG_DRAW,
+    FRAME_STAGE_SWAP,
+    FRAME_STAGE_SIM_TICK,    // Merged in from the simulation thread at exit
+    FRAME_STAGE_GPU_SCENE,   // GPU pass times, merged in from the GPU timer at exit
+    FRAME_STAGE_GPU_RINGS,
+    FRAME_STAGE_GPU_DEBUG_LINES,
+    FRAME_STAGE_COUNT
+};
+
+// Whole-run latency histograms per frame stage, plus a short rolling window of
+// frame intervals for the live title. Owned and recorded by the main thread.
+class FrameStats {
+public:
+    LatencyHistogram& get(FrameStage stage) { return histograms[stage]; }
+    const LatencyHistogram& get(FrameStage stage) const { return histograms[stage]; }
+
+    void recordFrame(uint64_t intervalNs);
+    const LatencyHistogram& getWindow() const { return window; }
+    void resetWindow() { window.reset(); }
+
+    // One CSV row per stage with count, mean and p50/p95/p99/p99.9/max in milliseconds
+    bool writeReport(const std::string& path) const;
+    static const char* getStageName(FrameStage stage);
+private:
+    LatencyHistogram histograms[FRAME_STAGE_COUNT];
+    LatencyHistogram window;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::reset() {
+    std::memset(counts, 0, sizeof(counts));
+    totalCount = 0;
+    minValue = UINT64_MAX;
+    maxValue = 0;
+    sum = 0;
+}
+
+int LatencyHistogram::getBucketIndex(uint64_t value) {
+    if (value < (uint64_t)(2 * kSubBucketCount)) {
+        return (int)value;
+    }
+    int msb = 63;
+    while (!(value >> msb)) --msb;
+    if (msb >= kMaxValueBits) {
+        return kBucketCount - 1;
+    }
+    // Keep the top kSubBucketBits + 1 bits: [64, 127] after the shift
+    int shift = msb - kSubBucketBits;
+    int subBucket = (int)(value >> shift) - kSubBucketCount;
+    return 2 * kSubBucketCount + (shift - 1) * kSubBucketCount + subBucket;
+}
+
+uint64_t LatencyHistogram::getBucketUpperBound(int index) {
+    if (index < 2 * kSubBucketCount) {
+        return (uint64_t)index;
+    }
+    int offset = index - 2 * kSubBucketCount;
+    int shift = offset / kSubBucketCount + 1;
+    uint64_t top = (uint64_t)(offset % kSubBucketCount + kSubBucketCount);
+    return ((top + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t valueNs) {
+    ++counts[getBucketIndex(valueNs)];
+    ++totalCount;
+    minValue = std::min(minValue, valueNs);
+    maxValue = std::max(maxValue, valueNs);
+    sum += valueNs;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < kBucketCount; ++i) {
+        counts[i] += other.counts[i];
+    }
+    totalCount += other.totalCount;
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+    sum += other.sum;
+}
+
+uint64_t LatencyHistogram::getPercentile(double percentile) const {
+    if (totalCount == 0) return 0;
+
+    double fraction = std::min(std::max(percentile, 0.0), 100.0) / 100.0;
+    uint64_t target = std::max<uint64_t>(1, (uint64_t)std::ceil(fraction * totalCount));
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += counts[i];
+        if (seen >= target) {
+            if (i == kBucketCount - 1) return maxValue; // Clamped values land here
+            // Bucket edges can overshoot the extremes; those are tracked exactly
+            return std::min(std::max(getBucketUpperBound(i), minValue), maxValue);
+        }
+    }
+    return maxValue;
+}
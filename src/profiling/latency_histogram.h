@@ -0,0 +1,58 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <chrono>
+#include <cstdint>
+
+// Fixed-memory latency histogram in the style of HdrHistogram. Values are
+// nanoseconds; below 128 ns each value has its own bucket, above that every
+// power of two is split into 64 linear buckets, so any recorded value is
+// reported within 1/64 (~1.6%) of its true value. Covers up to ~18 minutes
+// in 18 KB; larger values are clamped but max stays exact. Not thread-safe:
+// give each thread its own histogram and merge them when reporting.
+class LatencyHistogram {
+public:
+    static const int kSubBucketBits = 6;
+    static const int kSubBucketCount = 1 << kSubBucketBits;
+    static const int kMaxValueBits = 40;
+    static const int kBucketCount = 2 * kSubBucketCount + (kMaxValueBits - kSubBucketBits - 1) * kSubBucketCount;
+
+    LatencyHistogram();
+    void record(uint64_t valueNs);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    uint64_t getCount() const { return totalCount; }
+    uint64_t getMin() const { return totalCount > 0 ? minValue : 0; }
+    uint64_t getMax() const { return maxValue; }
+    double getMean() const { return totalCount > 0 ? (double)sum / totalCount : 0.0; }
+    // Smallest recorded value v such that percentile% of samples are <= v (to bucket precision)
+    uint64_t getPercentile(double percentile) const;
+private:
+    uint64_t counts[kBucketCount];
+    uint64_t totalCount;
+    uint64_t minValue;
+    uint64_t maxValue;
+    uint64_t sum;
+
+    static int getBucketIndex(uint64_t value);
+    static uint64_t getBucketUpperBound(int index);
+};
+
+// Records the lifetime of the enclosing scope into a histogram
+class LatencyScope {
+public:
+    explicit LatencyScope(LatencyHistogram& histogram)
+        : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+    ~LatencyScope() {
+        histogram.record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+    LatencyScope(const LatencyScope&) = delete;
+    LatencyScope& operator=(const LatencyScope&) = delete;
+private:
+    LatencyHistogram& histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif
@@ -0,0 +1,160 @@
+#include "profiler.h"
+#include <chrono>
+#include <cstdio>
+#include "logging/logger.h"
+
+namespace {
+thread_local ProfilerThreadBuffer* threadBuffer = nullptr;
+}
+
+ProfilerThreadBuffer::ProfilerThreadBuffer(size_t capacity)
+    : events(capacity), count(0), generation(0), dropped(0), threadId(0) {}
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler()
+    : capturing(false), generation(0), epochNs(0), captureStartNs(0), frameStartNs(0),
+      requestedFrames(0), remainingFrames(0) {
+    epochNs = now();
+}
+
+uint64_t Profiler::now() const {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count() - epochNs;
+}
+
+void Profiler::requestCapture(int frames, const std::string& path) {
+#if !(defined(DRONE_PROFILING) && DRONE_PROFILING)
+    (void)frames;
+    (void)path;
+    LOG_WARN("Profiler markers are compiled out; reconfigure with -DDRONE_PROFILING=ON");
+#else
+    if (isCapturing() || frames <= 0) return;
+    requestedFrames = frames;
+    requestedPath = path;
+    LOG_INFO("Profiling the next " << frames << " frames");
+#endif
+}
+
+void Profiler::endFrame() {
+    uint64_t frameEndNs = now();
+    if (isCapturing()) {
+        record("Frame", frameStartNs, frameEndNs);
+        if (--remainingFrames <= 0) {
+            capturing.store(false, std::memory_order_relaxed);
+            if (writeTrace(capturePath)) {
+                LOG_INFO("Profile trace written to " << capturePath);
+            }
+        }
+    } else if (requestedFrames > 0) {
+        // Bumping the generation makes every thread restart its buffer on its next event
+        generation.fetch_add(1, std::memory_order_release);
+        remainingFrames = requestedFrames;
+        capturePath = requestedPath;
+        requestedFrames = 0;
+        captureStartNs = frameEndNs;
+        capturing.store(true, std::memory_order_relaxed);
+    }
+    frameStartNs = frameEndNs;
+}
+
+void Profiler::setThreadName(const char* name) {
+    ProfilerThreadBuffer& buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    buffer.threadName = name;
+}
+
+ProfilerThreadBuffer& Profiler::getThreadBuffer() {
+    if (!threadBuffer) {
+        // First event on this thread; buffers outlive their threads so a capture can still be dumped
+        std::unique_ptr<ProfilerThreadBuffer> buffer(new ProfilerThreadBuffer(kEventsPerThread));
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        buffer->threadId = (uint32_t)threads.size() + 1;
+        threadBuffer = buffer.get();
+        threads.push_back(std::move(buffer));
+    }
+    return *threadBuffer;
+}
+
+void Profiler::record(const char* name, uint64_t startNs, uint64_t endNs) {
+    append(name, startNs, endNs - startNs, false);
+}
+
+void Profiler::recordCounter(const char* name, uint64_t timestampNs, uint64_t valueNs) {
+    append(name, timestampNs, valueNs, true);
+}
+
+void Profiler::append(const char* name, uint64_t startNs, uint64_t durationNs, bool counter) {
+    if (!isCapturing()) return;
+
+    ProfilerThreadBuffer& buffer = getThreadBuffer();
+    uint32_t currentGeneration = generation.load(std::memory_order_acquire);
+    if (buffer.generation.load(std::memory_order_relaxed) != currentGeneration) {
+        buffer.count.store(0, std::memory_order_relaxed);
+        buffer.dropped.store(0, std::memory_order_relaxed);
+        buffer.generation.store(currentGeneration, std::memory_order_release);
+    }
+
+    uint32_t index = buffer.count.load(std::memory_order_relaxed);
+    if (index >= buffer.events.size()) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ProfileEvent& event = buffer.events[index];
+    event.name = name;
+    event.startNs = startNs;
+    event.durationNs = durationNs;
+    event.counter = counter;
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+bool Profiler::writeTrace(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("Failed to open profile trace file: " << path);
+        return false;
+    }
+
+    uint32_t currentGeneration = generation.load(std::memory_order_acquire);
+    uint64_t droppedEvents = 0;
+    bool first = true;
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+
+    std::lock_guard<std::mutex> lock(threadsMutex);
+    for (const auto& buffer : threads) {
+        if (buffer->generation.load(std::memory_order_acquire) != currentGeneration) continue;
+        uint32_t count = buffer->count.load(std::memory_order_acquire);
+        droppedEvents += buffer->dropped.load(std::memory_order_relaxed);
+
+        std::string threadName = buffer->threadName.empty() ? "Thread " + std::to_string(buffer->threadId) : buffer->threadName;
+        std::fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                     first ? "" : ",\n", buffer->threadId, threadName.c_str());
+        first = false;
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const ProfileEvent& event = buffer->events[i];
+            if (event.counter) {
+                if (event.startNs < captureStartNs) continue;
+                std::fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"ms\":%.4f}}",
+                             event.name, buffer->threadId, (event.startNs - captureStartNs) / 1000.0, event.durationNs / 1e6);
+                continue;
+            }
+            // Scopes that began just before the capture started are clipped to its start
+            uint64_t startNs = event.startNs > captureStartNs ? event.startNs : captureStartNs;
+            uint64_t endNs = event.startNs + event.durationNs;
+            if (endNs < startNs) continue;
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                         event.name, buffer->threadId, (startNs - captureStartNs) / 1000.0, (endNs - startNs) / 1000.0);
+        }
+    }
+    std::fputs("\n]}\n", file);
+    bool ok = std::fclose(file) == 0;
+
+    if (droppedEvents > 0) {
+        LOG_WARN("Profiler dropped " << droppedEvents << " events; per-thread buffers hold " << kEventsPerThread);
+    }
+    return ok;
+}
@@ -0,0 +1,114 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// One completed scope, or a counter sample when counter is set (durationNs then holds
+// the value in ns); name must be a string literal (or otherwise outlive the profiler)
+struct ProfileEvent {
+    const char* name;
+    uint64_t startNs;
+    uint64_t durationNs;
+    bool counter;
+};
+
+// Events recorded by one thread. Only the owning thread writes; the count is
+// published with release semantics so the dump can read [0, count) without locks.
+struct ProfilerThreadBuffer {
+    std::vector<ProfileEvent> events;
+    std::atomic<uint32_t> count;
+    std::atomic<uint32_t> generation;
+    std::atomic<uint32_t> dropped;
+    uint32_t threadId;
+    std::string threadName;
+
+    explicit ProfilerThreadBuffer(size_t capacity);
+};
+
+// Hierarchical CPU profiler. Scopes cost one relaxed load when no capture is
+// running. A capture records every scope on every thread for a window of
+// frames and then writes a Chrome trace_event JSON file (chrome://tracing or
+// ui.perfetto.dev); nesting shows up from the timestamps.
+class Profiler {
+public:
+    static const size_t kEventsPerThread = 1 << 16;
+
+    static Profiler& instance();
+
+    // Starts a capture at the next frame boundary; ignored while one is running.
+    // requestCapture and endFrame must be called from the same (main) thread.
+    void requestCapture(int frames, const std::string& path);
+    // Frame boundary, called once per frame by the main loop
+    void endFrame();
+    bool isCapturing() const { return capturing.load(std::memory_order_relaxed); }
+
+    // Labels the calling thread in the trace
+    void setThreadName(const char* name);
+
+    uint64_t now() const;
+    void record(const char* name, uint64_t startNs, uint64_t endNs);
+    // Duration measured elsewhere (e.g. on the GPU), shown as a counter track in milliseconds
+    void recordCounter(const char* name, uint64_t timestampNs, uint64_t valueNs);
+private:
+    Profiler();
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    std::atomic<bool> capturing;
+    std::atomic<uint32_t> generation;
+    std::mutex threadsMutex;
+    std::vector<std::unique_ptr<ProfilerThreadBuffer>> threads;
+    uint64_t epochNs;
+    uint64_t captureStartNs;
+    uint64_t frameStartNs;
+    int requestedFrames;
+    int remainingFrames;
+    std::string requestedPath;
+    std::string capturePath;
+
+    ProfilerThreadBuffer& getThreadBuffer();
+    void append(const char* name, uint64_t startNs, uint64_t durationNs, bool counter);
+    bool writeTrace(const std::string& path);
+};
+
+// Times the enclosing scope while a capture is running
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : name(name), active(Profiler::instance().isCapturing()), startNs(0) {
+        if (active) {
+            startNs = Profiler::instance().now();
+        }
+    }
+    ~ProfileScope() {
+        if (active) {
+            Profiler::instance().record(name, startNs, Profiler::instance().now());
+        }
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+private:
+    const char* name;
+    bool active;
+    uint64_t startNs;
+};
+
+// Markers compile to nothing unless built with -DDRONE_PROFILING=1 (CMake option DRONE_PROFILING)
+#if defined(DRONE_PROFILING) && DRONE_PROFILING
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define PROFILE_THREAD_NAME(name) Profiler::instance().setThreadName(name)
+#define PROFILE_END_FRAME() Profiler::instance().endFrame()
+#else
+#define PROFILE_SCOPE(name) do {} while (0)
+#define PROFILE_THREAD_NAME(name) do {} while (0)
+#define PROFILE_END_FRAME() do {} while (0)
+#endif
+
+#endif
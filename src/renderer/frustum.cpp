@@ -0,0 +1,123 @@
+#include "frustum.h"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FRUSTUM_USE_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FRUSTUM_USE_NEON 1
+#endif
+
+void BoundingSpheres::clear() {
+    x.clear();
+    y.clear();
+    z.clear();
+    radius.clear();
+}
+
+void BoundingSpheres::add(const glm::vec3& center, float r) {
+    x.push_back(center.x);
+    y.push_back(center.y);
+    z.push_back(center.z);
+    radius.push_back(r);
+}
+
+Frustum::Frustum() {
+    // Accept everything until the first update
+    for (auto& plane : planes) {
+        plane = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+}
+
+void Frustum::update(const glm::mat4& m) {
+    // Gribb/Hartmann extraction; glm is column-major so row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    planes[0] = row3 + row0; // Left
+    planes[1] = row3 - row0; // Right
+    planes[2] = row3 + row1; // Bottom
+    planes[3] = row3 - row1; // Top
+    planes[4] = row3 + row2; // Near
+    planes[5] = row3 - row2; // Far
+
+    // Normalize so plane distances are in world units and comparable to radii
+    for (auto& plane : planes) {
+        float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        if (length > 0.0f) {
+            plane = plane / length;
+        }
+    }
+}
+
+bool Frustum::isSphereVisible(const glm::vec3& center, float radius) const {
+    for (const auto& plane : planes) {
+        if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int Frustum::cullSpheres(const BoundingSpheres& spheres, std::vector<uint8_t>& visible) const {
+    const int count = spheres.size();
+    visible.resize(count);
+    const float* xs = spheres.x.data();
+    const float* ys = spheres.y.data();
+    const float* zs = spheres.z.data();
+    const float* rs = spheres.radius.data();
+
+    int visibleCount = 0;
+    int i = 0;
+
+#if defined(FRUSTUM_USE_SSE)
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(xs + i);
+        __m128 y = _mm_loadu_ps(ys + i);
+        __m128 z = _mm_loadu_ps(zs + i);
+        __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(rs + i));
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const auto& plane : planes) {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(plane.x)), _mm_mul_ps(y, _mm_set1_ps(plane.y))),
+                                  _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negRadius));
+        }
+        int mask = _mm_movemask_ps(inside);
+        for (int lane = 0; lane < 4; ++lane) {
+            uint8_t isVisible = (uint8_t)((mask >> lane) & 1);
+            visible[i + lane] = isVisible;
+            visibleCount += isVisible;
+        }
+    }
+#elif defined(FRUSTUM_USE_NEON)
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t x = vld1q_f32(xs + i);
+        float32x4_t y = vld1q_f32(ys + i);
+        float32x4_t z = vld1q_f32(zs + i);
+        float32x4_t negRadius = vnegq_f32(vld1q_f32(rs + i));
+        uint32x4_t inside = vdupq_n_u32(0xFFFFFFFFu);
+        for (const auto& plane : planes) {
+            float32x4_t d = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(plane.w), x, plane.x), y, plane.y), z, plane.z);
+            inside = vandq_u32(inside, vcgeq_f32(d, negRadius));
+        }
+        uint32_t lanes[4];
+        vst1q_u32(lanes, inside);
+        for (int lane = 0; lane < 4; ++lane) {
+            uint8_t isVisible = lanes[lane] ? 1 : 0;
+            visible[i + lane] = isVisible;
+            visibleCount += isVisible;
+        }
+    }
+#endif
+
+    // Scalar tail (or whole array without SIMD)
+    for (; i < count; ++i) {
+        uint8_t isVisible = isSphereVisible(glm::vec3(xs[i], ys[i], zs[i]), rs[i]) ? 1 : 0;
+        visible[i] = isVisible;
+        visibleCount += isVisible;
+    }
+    return visibleCount;
+}
@@ -0,0 +1,39 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Bounding spheres stored structure-of-arrays so they can be culled four at a time
+struct BoundingSpheres {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> radius;
+
+    void clear();
+    void add(const glm::vec3& center, float r);
+    int size() const { return (int)x.size(); }
+};
+
+// Per-frame culling counters
+struct CullStats {
+    int tested = 0;
+    int visible = 0;
+    int culled() const { return tested - visible; }
+};
+
+// View frustum as six inward-facing planes extracted from a view-projection matrix
+class Frustum {
+public:
+    Frustum();
+    void update(const glm::mat4& viewProjection);
+    bool isSphereVisible(const glm::vec3& center, float radius) const;
+    // Writes 1/0 per sphere into visible and returns the number of visible spheres
+    int cullSpheres(const BoundingSpheres& spheres, std::vector<uint8_t>& visible) const;
+private:
+    glm::vec4 planes[6];
+};
+
+#endif
@@ -0,0 +1,99 @@
+#include "gpu_timer.h"
+#include "logging/logger.h"
+#include "profiling/profiler.h"
+
+GpuTimer::GpuTimer() : frameIndex(0), activePass(-1), enabled(false), missedResults(0) {
+    for (auto& frame : frames) {
+        for (int pass = 0; pass < GPU_PASS_COUNT; ++pass) {
+            frame.queries[pass] = 0;
+            frame.issued[pass] = false;
+        }
+        frame.submitNs = 0;
+    }
+    for (auto& ns : lastPassNs) {
+        ns = 0;
+    }
+}
+
+GpuTimer::~GpuTimer() {
+    if (!enabled) return;
+    for (auto& frame : frames) {
+        glDeleteQueries(GPU_PASS_COUNT, frame.queries);
+    }
+}
+
+bool GpuTimer::init() {
+    // TIME_ELAPSED queries are core in 3.3, including Mesa's software rasterizers
+    if (!GLAD_GL_VERSION_3_3) {
+        LOG_WARN("GPU timer queries unavailable; GPU pass timing disabled");
+        return false;
+    }
+    for (auto& frame : frames) {
+        glGenQueries(GPU_PASS_COUNT, frame.queries);
+    }
+    enabled = true;
+    return true;
+}
+
+void GpuTimer::beginFrame() {
+    if (!enabled) return;
+
+    frameIndex = (frameIndex + 1) % kFrameLatency;
+    FrameQueries& frame = frames[frameIndex];
+    for (int pass = 0; pass < GPU_PASS_COUNT; ++pass) {
+        if (!frame.issued[pass]) {
+            lastPassNs[pass] = 0; // Pass wasn't drawn that frame
+            continue;
+        }
+        frame.issued[pass] = false;
+
+        GLuint available = 0;
+        glGetQueryObjectuiv(frame.queries[pass], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            // Never wait; reissuing the query discards the old result
+            ++missedResults;
+            continue;
+        }
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(frame.queries[pass], GL_QUERY_RESULT, &elapsedNs);
+        lastPassNs[pass] = elapsedNs;
+        passHistograms[pass].record(elapsedNs);
+#if defined(DRONE_PROFILING) && DRONE_PROFILING
+        Profiler::instance().recordCounter(getPassName((GpuPass)pass), frame.submitNs, elapsedNs);
+#endif
+    }
+    frame.submitNs = Profiler::instance().now();
+}
+
+bool GpuTimer::beginPass(GpuPass pass) {
+    if (!enabled || activePass >= 0) return false;
+    FrameQueries& frame = frames[frameIndex];
+    if (frame.issued[pass]) return false;
+    glBeginQuery(GL_TIME_ELAPSED, frame.queries[pass]);
+    frame.issued[pass] = true;
+    activePass = pass;
+    return true;
+}
+
+void GpuTimer::endPass() {
+    if (activePass < 0) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    activePass = -1;
+}
+
+float GpuTimer::getFrameMilliseconds() const {
+    uint64_t total = 0;
+    for (uint64_t ns : lastPassNs) {
+        total += ns;
+    }
+    return total / 1e6f;
+}
+
+const char* GpuTimer::getPassName(GpuPass pass) {
+    switch (pass) {
+        case GPU_PASS_SCENE: return "GPU scene";
+        case GPU_PASS_RINGS: return "GPU rings";
+        case GPU_PASS_DEBUG_LINES: return "GPU debug lines";
+        default: return "GPU unknown";
+    }
+}
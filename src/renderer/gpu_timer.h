@@ -0,0 +1,71 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include "profiling/latency_histogram.h"
+
+enum GpuPass {
+    GPU_PASS_SCENE = 0,     // Ground and drone
+    GPU_PASS_RINGS,
+    GPU_PASS_DEBUG_LINES,
+    GPU_PASS_COUNT
+};
+
+// Per-pass GPU timing with GL_TIME_ELAPSED queries. Each frame uses its own
+// set of query objects from a small ring, and results are collected when that
+// set comes round again kFrameLatency frames later, so reading them never
+// stalls the pipeline. Results that still aren't ready are skipped and counted.
+// Passes can't nest (GL allows one TIME_ELAPSED query at a time).
+class GpuTimer {
+public:
+    static const int kFrameLatency = 4;
+
+    GpuTimer();
+    ~GpuTimer();
+    // Returns false (and stays disabled) without GL 3.3 timer queries
+    bool init();
+    bool isEnabled() const { return enabled; }
+
+    // Collects the results of the frame whose queries are about to be reused
+    void beginFrame();
+    // False if the pass can't be timed (disabled, another pass open, or already timed this frame)
+    bool beginPass(GpuPass pass);
+    void endPass();
+
+    // Latest resolved time of a pass, a few frames old
+    float getPassMilliseconds(GpuPass pass) const { return lastPassNs[pass] / 1e6f; }
+    float getFrameMilliseconds() const;
+    const LatencyHistogram& getPassHistogram(GpuPass pass) const { return passHistograms[pass]; }
+    uint64_t getMissedResults() const { return missedResults; }
+    static const char* getPassName(GpuPass pass);
+private:
+    struct FrameQueries {
+        GLuint queries[GPU_PASS_COUNT];
+        bool issued[GPU_PASS_COUNT];
+        uint64_t submitNs;
+    };
+
+    FrameQueries frames[kFrameLatency];
+    int frameIndex;
+    int activePass;
+    bool enabled;
+    uint64_t lastPassNs[GPU_PASS_COUNT];
+    LatencyHistogram passHistograms[GPU_PASS_COUNT];
+    uint64_t missedResults;
+};
+
+// Times the enclosing scope as one GPU pass; a null timer does nothing
+class GpuPassScope {
+public:
+    GpuPassScope(GpuTimer* timer, GpuPass pass) : timer(timer && timer->beginPass(pass) ? timer : nullptr) {}
+    ~GpuPassScope() {
+        if (timer) timer->endPass();
+    }
+    GpuPassScope(const GpuPassScope&) = delete;
+    GpuPassScope& operator=(const GpuPassScope&) = delete;
+private:
+    GpuTimer* timer;
+};
+
+#endif
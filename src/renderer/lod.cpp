@@ -0,0 +1,32 @@
+#include "lod.h"
+#include <algorithm>
+
+int LodChain::select(int currentLevel, float screenRadius) const {
+    const int lastLevel = getLevelCount() - 1;
+    if (lastLevel <= 0) return 0;
+
+    // First selection for this object: no previous level to stick to
+    if (currentLevel < 0 || currentLevel > lastLevel) {
+        int level = 0;
+        while (level < lastLevel && screenRadius < switchRadii[level]) {
+            ++level;
+        }
+        return level;
+    }
+
+    // Only cross a threshold once the object is clearly past it
+    int level = currentLevel;
+    while (level < lastLevel && screenRadius < switchRadii[level] * (1.0f - hysteresis)) {
+        ++level;
+    }
+    while (level > 0 && screenRadius > switchRadii[level - 1] * (1.0f + hysteresis)) {
+        --level;
+    }
+    return level;
+}
+
+float projectedScreenRadius(float worldRadius, float distance, float projectionScaleY, float viewportHeight) {
+    // projectionScaleY is projection[1][1] = 1 / tan(fovY / 2)
+    distance = std::max(distance, 1e-3f);
+    return worldRadius * projectionScaleY * 0.5f * viewportHeight / distance;
+}
@@ -0,0 +1,23 @@
+#ifndef LOD_H
+#define LOD_H
+
+#include <vector>
+#include "mesh_registry.h"
+
+// Mesh levels for one shape, finest first. switchRadii[i] is the projected
+// screen-space radius (pixels) below which level i hands over to level i + 1,
+// so it must be descending and have one entry fewer than levels.
+struct LodChain {
+    std::vector<MeshId> levels;
+    std::vector<float> switchRadii;
+    // Fractional dead band around each threshold so objects sitting on a boundary don't pop
+    float hysteresis = 0.15f;
+
+    int getLevelCount() const { return (int)levels.size(); }
+    int select(int currentLevel, float screenRadius) const;
+};
+
+// Approximate on-screen radius in pixels of a sphere at the given view distance
+float projectedScreenRadius(float worldRadius, float distance, float projectionScaleY, float viewportHeight);
+
+#endif
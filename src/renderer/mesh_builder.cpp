@@ -0,0 +1,270 @@
+#include "mesh_builder.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+
+namespace {
+
+const float kPi = 3.14159265358979f;
+
+void pushVertex(MeshData& mesh, float x, float y, float z, float nx, float ny, float nz, float u, float v) {
+    mesh.vertices.insert(mesh.vertices.end(), {x, y, z, nx, ny, nz, u, v});
+}
+
+// Forsyth scoring parameters, from "Linear-Speed Vertex Cache Optimisation"
+const int kCacheSize = 32;
+const float kCacheDecayPower = 1.5f;
+const float kLastTriangleScore = 0.75f;
+const float kValenceBoostScale = 2.0f;
+const float kValenceBoostPower = 0.5f;
+
+float scoreVertex(int cachePosition, int remainingTriangles) {
+    if (remainingTriangles == 0) {
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        if (cachePosition < 3) {
+            // The triangle just emitted; using it again right away gains nothing extra
+            score = kLastTriangleScore;
+        } else {
+            float scaler = 1.0f / (kCacheSize - 3);
+            score = std::pow(1.0f - (cachePosition - 3) * scaler, kCacheDecayPower);
+        }
+    }
+
+    // Favour vertices with few triangles left so they don't get stranded
+    score += kValenceBoostScale * std::pow((float)remainingTriangles, -kValenceBoostPower);
+    return score;
+}
+
+} // namespace
+
+MeshData buildGroundPlane(float halfSize) {
+    MeshData mesh;
+    pushVertex(mesh, -halfSize, 0.0f, -halfSize, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f);
+    pushVertex(mesh,  halfSize, 0.0f, -halfSize, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f);
+    pushVertex(mesh,  halfSize, 0.0f,  halfSize, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f);
+    pushVertex(mesh, -halfSize, 0.0f,  halfSize, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f);
+    mesh.indices = {0, 1, 2, 0, 2, 3};
+    return mesh;
+}
+
+MeshData buildSphere(float radius, int stacks, int slices) {
+    MeshData mesh;
+    mesh.vertices.reserve((size_t)(stacks + 1) * (slices + 1) * MeshData::kFloatsPerVertex);
+    mesh.indices.reserve((size_t)stacks * slices * 6);
+
+    for (int i = 0; i <= stacks; ++i) {
+        float phi = kPi * i / stacks; // from 0 to π
+        for (int j = 0; j <= slices; ++j) {
+            float theta = 2.0f * kPi * j / slices; // from 0 to 2π
+
+            // Normal (same as position for unit sphere)
+            float nx = std::sin(phi) * std::cos(theta);
+            float ny = std::cos(phi);
+            float nz = std::sin(phi) * std::sin(theta);
+
+            pushVertex(mesh, radius * nx, radius * ny, radius * nz, nx, ny, nz, (float)j / slices, (float)i / stacks);
+        }
+    }
+
+    // Two triangles per quad
+    for (int i = 0; i < stacks; ++i) {
+        for (int j = 0; j < slices; ++j) {
+            unsigned int first = (unsigned int)(i * (slices + 1) + j);
+            unsigned int second = first + slices + 1;
+            mesh.indices.insert(mesh.indices.end(), {first, second, first + 1});
+            mesh.indices.insert(mesh.indices.end(), {second, second + 1, first + 1});
+        }
+    }
+    return mesh;
+}
+
+MeshData buildTorus(float majorRadius, float minorRadius, int majorSegments, int minorSegments) {
+    MeshData mesh;
+    mesh.vertices.reserve((size_t)(majorSegments + 1) * (minorSegments + 1) * MeshData::kFloatsPerVertex);
+    mesh.indices.reserve((size_t)majorSegments * minorSegments * 6);
+
+    // The seam row/column is duplicated so texture coordinates can wrap cleanly
+    for (int i = 0; i <= majorSegments; ++i) {
+        float theta = 2.0f * kPi * i / majorSegments;
+        for (int j = 0; j <= minorSegments; ++j) {
+            float phi = 2.0f * kPi * j / minorSegments;
+
+            float ringRadius = majorRadius + minorRadius * std::cos(phi);
+            pushVertex(mesh,
+                       ringRadius * std::cos(theta), minorRadius * std::sin(phi), ringRadius * std::sin(theta),
+                       std::cos(theta) * std::cos(phi), std::sin(phi), std::sin(theta) * std::cos(phi),
+                       (float)i / majorSegments, (float)j / minorSegments);
+        }
+    }
+
+    for (int i = 0; i < majorSegments; ++i) {
+        for (int j = 0; j < minorSegments; ++j) {
+            unsigned int a = (unsigned int)(i * (minorSegments + 1) + j);
+            unsigned int b = a + 1;
+            unsigned int c = a + minorSegments + 1;
+            unsigned int d = c + 1;
+            mesh.indices.insert(mesh.indices.end(), {a, b, c});
+            mesh.indices.insert(mesh.indices.end(), {b, d, c});
+        }
+    }
+    return mesh;
+}
+
+void optimizeVertexCache(MeshData& mesh) {
+    const int vertexCount = mesh.getVertexCount();
+    const int triangleCount = mesh.getIndexCount() / 3;
+    if (triangleCount == 0) return;
+
+    // Vertex -> triangle adjacency in CSR form
+    std::vector<int> adjacencyOffset(vertexCount + 1, 0);
+    for (unsigned int index : mesh.indices) {
+        adjacencyOffset[index + 1]++;
+    }
+    for (int v = 0; v < vertexCount; ++v) {
+        adjacencyOffset[v + 1] += adjacencyOffset[v];
+    }
+    std::vector<int> adjacency(mesh.indices.size());
+    std::vector<int> remaining(vertexCount, 0);
+    for (int t = 0; t < triangleCount; ++t) {
+        for (int k = 0; k < 3; ++k) {
+            unsigned int v = mesh.indices[t * 3 + k];
+            adjacency[adjacencyOffset[v] + remaining[v]++] = t;
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (int v = 0; v < vertexCount; ++v) {
+        vertexScore[v] = scoreVertex(-1, remaining[v]);
+    }
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    for (int t = 0; t < triangleCount; ++t) {
+        triangleScore[t] = vertexScore[mesh.indices[t * 3]] + vertexScore[mesh.indices[t * 3 + 1]] +
+                           vertexScore[mesh.indices[t * 3 + 2]];
+    }
+
+    std::vector<unsigned int> optimized;
+    optimized.reserve(mesh.indices.size());
+    std::vector<int> cache;
+    cache.reserve(kCacheSize + 3);
+    std::vector<int> nextCache;
+    nextCache.reserve(kCacheSize + 3);
+
+    int bestTriangle = -1;
+    int scanCursor = 0;
+    for (int emittedCount = 0; emittedCount < triangleCount; ++emittedCount) {
+        if (bestTriangle < 0) {
+            // Nothing useful in the cache; fall back to the best remaining triangle
+            float bestScore = -1e30f;
+            for (int t = scanCursor; t < triangleCount; ++t) {
+                if (!emitted[t] && triangleScore[t] > bestScore) {
+                    bestScore = triangleScore[t];
+                    bestTriangle = t;
+                }
+            }
+            while (scanCursor < triangleCount && emitted[scanCursor]) {
+                ++scanCursor;
+            }
+        }
+
+        int t = bestTriangle;
+        emitted[t] = true;
+        nextCache.clear();
+        for (int k = 0; k < 3; ++k) {
+            unsigned int v = mesh.indices[t * 3 + k];
+            optimized.push_back(v);
+            nextCache.push_back((int)v);
+
+            // Drop the triangle from the vertex's remaining list
+            int begin = adjacencyOffset[v];
+            int end = begin + remaining[v];
+            for (int i = begin; i < end; ++i) {
+                if (adjacency[i] == t) {
+                    std::swap(adjacency[i], adjacency[end - 1]);
+                    break;
+                }
+            }
+            remaining[v]--;
+        }
+
+        // Emitted vertices move to the front of the LRU cache
+        for (int v : cache) {
+            if (std::find(nextCache.begin(), nextCache.begin() + 3, v) == nextCache.begin() + 3) {
+                nextCache.push_back(v);
+            }
+        }
+
+        // Refresh scores of everything that was or is in the cache
+        for (size_t i = 0; i < nextCache.size(); ++i) {
+            int v = nextCache[i];
+            cachePosition[v] = i < (size_t)kCacheSize ? (int)i : -1;
+            vertexScore[v] = scoreVertex(cachePosition[v], remaining[v]);
+        }
+        if (nextCache.size() > (size_t)kCacheSize) {
+            nextCache.resize(kCacheSize);
+        }
+        cache.swap(nextCache);
+
+        // Next triangle is the best one touching the cache
+        bestTriangle = -1;
+        float bestScore = -1e30f;
+        for (int v : cache) {
+            for (int i = adjacencyOffset[v]; i < adjacencyOffset[v] + remaining[v]; ++i) {
+                int candidate = adjacency[i];
+                const unsigned int* tri = &mesh.indices[candidate * 3];
+                float score = vertexScore[tri[0]] + vertexScore[tri[1]] + vertexScore[tri[2]];
+                triangleScore[candidate] = score;
+                if (score > bestScore) {
+                    bestScore = score;
+                    bestTriangle = candidate;
+                }
+            }
+        }
+    }
+
+    // Renumber vertices in first-use order so fetches walk memory linearly
+    std::vector<int> remap(vertexCount, -1);
+    int nextVertex = 0;
+    for (unsigned int& index : optimized) {
+        if (remap[index] < 0) {
+            remap[index] = nextVertex++;
+        }
+        index = (unsigned int)remap[index];
+    }
+
+    std::vector<float> reordered((size_t)nextVertex * MeshData::kFloatsPerVertex);
+    for (int v = 0; v < vertexCount; ++v) {
+        if (remap[v] < 0) continue; // Unreferenced vertices are dropped
+        std::copy(mesh.vertices.begin() + (size_t)v * MeshData::kFloatsPerVertex,
+                  mesh.vertices.begin() + (size_t)(v + 1) * MeshData::kFloatsPerVertex,
+                  reordered.begin() + (size_t)remap[v] * MeshData::kFloatsPerVertex);
+    }
+
+    mesh.vertices.swap(reordered);
+    mesh.indices.swap(optimized);
+}
+
+float computeAverageCacheMissRatio(const std::vector<unsigned int>& indices, int vertexCount, int cacheSize) {
+    if (indices.size() < 3) return 0.0f;
+
+    std::vector<bool> cached(vertexCount, false);
+    std::deque<unsigned int> fifo;
+    int misses = 0;
+    for (unsigned int index : indices) {
+        if (cached[index]) continue;
+        ++misses;
+        cached[index] = true;
+        fifo.push_back(index);
+        if ((int)fifo.size() > cacheSize) {
+            cached[fifo.front()] = false;
+            fifo.pop_front();
+        }
+    }
+    return (float)misses / (float)(indices.size() / 3);
+}
@@ -0,0 +1,29 @@
+#ifndef MESH_BUILDER_H
+#define MESH_BUILDER_H
+
+#include <vector>
+
+// CPU-side indexed mesh. Vertices are interleaved position(3), normal(3), texcoord(2).
+struct MeshData {
+    static const int kFloatsPerVertex = 8;
+
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+
+    int getVertexCount() const { return (int)(vertices.size() / kFloatsPerVertex); }
+    int getIndexCount() const { return (int)indices.size(); }
+};
+
+// Procedural shapes (no GL calls, so they can also run headless)
+MeshData buildGroundPlane(float halfSize);
+MeshData buildSphere(float radius, int stacks, int slices);
+MeshData buildTorus(float majorRadius, float minorRadius, int majorSegments, int minorSegments);
+
+// Reorders triangles for post-transform vertex cache reuse (Forsyth's linear-speed
+// algorithm), then reorders vertices into first-use order for fetch locality
+void optimizeVertexCache(MeshData& mesh);
+
+// Average vertex shader invocations per triangle for a FIFO cache of the given size
+float computeAverageCacheMissRatio(const std::vector<unsigned int>& indices, int vertexCount, int cacheSize = 16);
+
+#endif
@@ -0,0 +1,86 @@
+#include "mesh_registry.h"
+#include "logging/logger.h"
+
+MeshRegistry::MeshRegistry() {}
+
+MeshRegistry::~MeshRegistry() {
+    clear();
+}
+
+MeshId MeshRegistry::add(const std::string& name, MeshData data, bool optimize) {
+    float acmrBefore = computeAverageCacheMissRatio(data.indices, data.getVertexCount());
+    if (optimize) {
+        optimizeVertexCache(data);
+    }
+    float acmrAfter = computeAverageCacheMissRatio(data.indices, data.getVertexCount());
+
+    Mesh mesh;
+    mesh.name = name;
+    mesh.vertexCount = (GLsizei)data.getVertexCount();
+    mesh.indexCount = (GLsizei)data.getIndexCount();
+
+    glGenVertexArrays(1, &mesh.VAO);
+    glGenBuffers(1, &mesh.VBO);
+    glGenBuffers(1, &mesh.EBO);
+
+    glBindVertexArray(mesh.VAO);
+
+    // Vertex buffer
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+    glBufferData(GL_ARRAY_BUFFER, data.vertices.size() * sizeof(float), data.vertices.data(), GL_STATIC_DRAW);
+
+    // Index buffer (recorded in the VAO)
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.indices.size() * sizeof(unsigned int), data.indices.data(), GL_STATIC_DRAW);
+
+    // Vertex attributes
+    const GLsizei stride = MeshData::kFloatsPerVertex * sizeof(float);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    LOG_INFO("Mesh '" << name << "': " << mesh.vertexCount << " vertices, " << mesh.indexCount / 3
+             << " triangles, ACMR " << acmrBefore << " -> " << acmrAfter);
+
+    meshes.push_back(mesh);
+    return (MeshId)meshes.size() - 1;
+}
+
+MeshId MeshRegistry::find(const std::string& name) const {
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        if (meshes[i].name == name) {
+            return (MeshId)i;
+        }
+    }
+    return -1;
+}
+
+void MeshRegistry::draw(MeshId id) const {
+    const Mesh& mesh = meshes[id];
+    glBindVertexArray(mesh.VAO);
+    glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
+}
+
+void MeshRegistry::drawInstanced(MeshId id, GLsizei instanceCount) const {
+    const Mesh& mesh = meshes[id];
+    glBindVertexArray(mesh.VAO);
+    glDrawElementsInstanced(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, 0, instanceCount);
+    glBindVertexArray(0);
+}
+
+void MeshRegistry::clear() {
+    for (Mesh& mesh : meshes) {
+        glDeleteVertexArrays(1, &mesh.VAO);
+        glDeleteBuffers(1, &mesh.VBO);
+        glDeleteBuffers(1, &mesh.EBO);
+    }
+    meshes.clear();
+}
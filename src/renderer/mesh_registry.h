@@ -0,0 +1,40 @@
+#ifndef MESH_REGISTRY_H
+#define MESH_REGISTRY_H
+
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include "mesh_builder.h"
+
+typedef int MeshId;
+
+// GPU-resident indexed mesh. Counts travel with the buffers so draws never
+// have to recompute them.
+struct Mesh {
+    std::string name;
+    GLuint VAO = 0;
+    GLuint VBO = 0;
+    GLuint EBO = 0;
+    GLsizei vertexCount = 0;
+    GLsizei indexCount = 0;
+};
+
+// Owns every static mesh the renderer draws and the GL objects behind them
+class MeshRegistry {
+public:
+    MeshRegistry();
+    ~MeshRegistry();
+    MeshRegistry(const MeshRegistry&) = delete;
+    MeshRegistry& operator=(const MeshRegistry&) = delete;
+
+    MeshId add(const std::string& name, MeshData data, bool optimize = true);
+    MeshId find(const std::string& name) const;
+    const Mesh& get(MeshId id) const { return meshes[id]; }
+    void draw(MeshId id) const;
+    void drawInstanced(MeshId id, GLsizei instanceCount) const;
+    void clear();
+private:
+    std::vector<Mesh> meshes;
+};
+
+#endif
@@ -1,17 +1,25 @@
 #include "renderer.h"
-#include <iostream>
 #include <fstream>
+#include <cmath>
+#include <cstddef>
+#include "logging/logger.h"
+#include "profiling/profiler.h"
+
+namespace {
+// Ground is a square of this half-size centred on the origin
+const float kGroundHalfSize = 10.0f;
+}
 
-Renderer::Renderer() {}
+Renderer::Renderer()
+    : sceneModelLoc(-1), sceneObjectColorLoc(-1), frameUBO(0), frameUniformsValid(false),
+      groundMesh(-1), droneLevel(-1), currentRingIndex(0), ringInstancesDirty(true), ringUploadNeeded(true),
+      submittedTriangles(0), gpuTimer(nullptr), cameraPosition(0.0f, 5.0f, 5.0f), viewportHeight(768) {}
 
 Renderer::~Renderer() {
-    glDeleteVertexArrays(1, &groundVAO);
-    glDeleteBuffers(1, &groundVBO);
-    glDeleteVertexArrays(1, &cubeVAO);
-    glDeleteBuffers(1, &cubeVBO);
-    glDeleteVertexArrays(1, &torusVAO);
-    glDeleteBuffers(1, &torusVBO);
-    glDeleteProgram(shaderProgram);
+    for (auto& batch : ringBatches) {
+        glDeleteBuffers(1, &batch.instanceVBO);
+    }
+    glDeleteBuffers(1, &frameUBO);
 }
 
 bool Renderer::init() {
@@ -22,12 +30,15 @@ bool Renderer::init() {
         glBindVertexArray(defaultVAO);
 
         createShaderProgram();
+        createFrameUniformBuffer();
         createGroundPlane();
         createCube();
         createTorus();
+        createRingInstanceBuffer();
 
         // Set projection matrix
-        projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+        // Far plane covers long tracks; frustum culling keeps distant geometry cheap
+        projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 1000.0f);
 
         // Set initial view matrix
         view = glm::lookAt(glm::vec3(0, 5, 5), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
@@ -43,59 +54,167 @@ bool Renderer::init() {
         cameraYaw = 0.0f;
         cameraPitch = 0.0f;
 
-        std::cout << "Renderer initialized successfully" << std::endl;
+        LOG_INFO("Renderer initialized successfully");
         return true;
     } catch (const std::exception& e) {
-        std::cerr << "ERROR: Failed to initialize renderer: " << e.what() << std::endl;
+        LOG_ERROR("Failed to initialize renderer: " << e.what());
         return false;
     }
 }
 
 void Renderer::render() {
-    glUseProgram(shaderProgram);
-
-    // Set lighting uniforms
-    glUniform3f(glGetUniformLocation(shaderProgram, "lightPos"), 1.2f, 1.0f, 2.0f);
-    glUniform3f(glGetUniformLocation(shaderProgram, "lightPos2"), -1.2f, 2.0f, -2.0f); // Secondary light position
-    glUniform3f(glGetUniformLocation(shaderProgram, "viewPos"), 0.0f, 5.0f, 5.0f);
-    glUniform3f(glGetUniformLocation(shaderProgram, "lightColor"), 1.0f, 1.0f, 1.0f);
-    glUniform3f(glGetUniformLocation(shaderProgram, "lightColor2"), 0.7f, 0.8f, 1.0f); // Softer blue fill light
-    glUniform3f(glGetUniformLocation(shaderProgram, "objectColor"), 0.8f, 0.8f, 0.9f); // Brighter, slightly blue-tinted
-
-    // Set matrices
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-
-    // Render ground plane
-    glm::mat4 model = glm::mat4(1.0f);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(model));
-    glBindVertexArray(groundVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
+    PROFILE_SCOPE("Renderer::render");
+    updateFrameUniforms();
+    sceneShader.use();
+
+    // Cull against the current camera before submitting anything
+    frustum.update(projection * view);
+    cullStats = CullStats();
+    submittedTriangles = 0;
+
+    {
+        GpuPassScope gpuPass(gpuTimer, GPU_PASS_SCENE);
+
+        // Render ground plane
+        if (isSphereVisible(glm::vec3(0.0f), kGroundHalfSize * std::sqrt(2.0f))) {
+            glm::mat4 model = glm::mat4(1.0f);
+            glUniformMatrix4fv(sceneModelLoc, 1, GL_FALSE, glm::value_ptr(model));
+            meshes.draw(groundMesh);
+            submittedTriangles += meshes.get(groundMesh).indexCount / 3;
+        }
 
-    // Render sphere (drone)
-    glm::mat4 cubeModel = glm::translate(glm::mat4(1.0f), dronePosition);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(cubeModel));
-    glBindVertexArray(cubeVAO);
-    glDrawElements(GL_TRIANGLES, 16 * 16 * 6, GL_UNSIGNED_INT, 0); // Sphere with 16x16 divisions
-    glBindVertexArray(0);
+        // Render sphere (drone) at a detail level matching its size on screen
+        if (isSphereVisible(dronePosition, 0.3f)) {
+            droneLevel = droneLods.select(droneLevel, getScreenRadius(dronePosition, 0.3f));
+            MeshId droneMesh = droneLods.levels[droneLevel];
+            glm::mat4 cubeModel = glm::translate(glm::mat4(1.0f), dronePosition);
+            glUniformMatrix4fv(sceneModelLoc, 1, GL_FALSE, glm::value_ptr(cubeModel));
+            meshes.draw(droneMesh);
+            submittedTriangles += meshes.get(droneMesh).indexCount / 3;
+        }
+    }
 
     // Render toruses (rings)
-    for (const auto& ringPos : ringPositions) {
-        glm::mat4 torusModel = glm::translate(glm::mat4(1.0f), ringPos);
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(torusModel));
-        glBindVertexArray(torusVAO);
-        // Calculate actual vertex count from torus generation (each triangle has 3 vertices)
-        int numMajor = 16;
-        int numMinor = 8;
-        int trianglesPerQuad = 2; // 2 triangles per quad
-        int verticesPerTriangle = 3;
-        int vertexCount = numMajor * numMinor * trianglesPerQuad * verticesPerTriangle;
-        glDrawArrays(GL_TRIANGLES, 0, vertexCount);
-        glBindVertexArray(0);
+    renderRings();
+}
+
+void Renderer::updateFrameUniforms() {
+    FrameUniforms current = frameUniforms;
+    current.view = view;
+    current.projection = projection;
+
+    // Lighting is constant; only camera changes make the block dirty
+    if (frameUniformsValid && current.view == frameUniforms.view && current.projection == frameUniforms.projection) {
+        return;
+    }
+
+    frameUniforms = current;
+    frameUniformsValid = true;
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &frameUniforms);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+bool Renderer::isSphereVisible(const glm::vec3& center, float radius) {
+    bool visible = frustum.isSphereVisible(center, radius);
+    cullStats.tested++;
+    cullStats.visible += visible ? 1 : 0;
+    return visible;
+}
+
+float Renderer::getScreenRadius(const glm::vec3& center, float radius) const {
+    return projectedScreenRadius(radius, glm::length(center - cameraPosition), projection[1][1], (float)viewportHeight);
+}
+
+void Renderer::renderRings() {
+    PROFILE_SCOPE("Renderer::renderRings");
+    if (ringPositions.empty()) return;
+
+    updateRingInstances();
+    cullRings();
+
+    // One instanced draw per LOD level covers every visible ring
+    GpuPassScope gpuPass(gpuTimer, GPU_PASS_RINGS);
+    ringShader.use();
+    for (int level = 0; level < ringLods.getLevelCount(); ++level) {
+        const RingLodBatch& batch = ringBatches[level];
+        if (batch.instances.empty()) continue;
+        meshes.drawInstanced(ringLods.levels[level], (GLsizei)batch.instances.size());
+        submittedTriangles += meshes.get(ringLods.levels[level]).indexCount / 3 * (int)batch.instances.size();
     }
 }
 
+void Renderer::updateRingInstances() {
+    if (!ringInstancesDirty) return;
+
+    ringInstances.resize(ringPositions.size());
+    // Keep each ring's LOD level across progress updates so hysteresis holds; new rings start unselected
+    ringLevels.resize(ringPositions.size(), -1);
+    ringBounds.clear();
+    for (size_t i = 0; i < ringPositions.size(); ++i) {
+        ringBounds.add(ringPositions[i], 1.3f); // Major + minor torus radius
+        RingInstance& instance = ringInstances[i];
+        instance.model = glm::translate(glm::mat4(1.0f), ringPositions[i]);
+        if ((int)i < currentRingIndex) {
+            instance.color = glm::vec3(0.3f, 0.8f, 0.3f); // Passed
+        } else if ((int)i == currentRingIndex) {
+            instance.color = glm::vec3(1.0f, 0.75f, 0.2f); // Next
+        } else {
+            instance.color = glm::vec3(0.8f, 0.8f, 0.9f); // Upcoming
+        }
+    }
+
+    ringInstancesDirty = false;
+    ringUploadNeeded = true;
+}
+
+void Renderer::cullRings() {
+    PROFILE_SCOPE("Renderer::cullRings");
+    int visibleCount = frustum.cullSpheres(ringBounds, ringVisibility);
+    cullStats.tested += ringBounds.size();
+    cullStats.visible += visibleCount;
+
+    // Selection per ring: 0 = culled, otherwise LOD level + 1
+    ringSelection.resize(ringVisibility.size());
+    for (size_t i = 0; i < ringVisibility.size(); ++i) {
+        if (!ringVisibility[i]) {
+            ringSelection[i] = 0;
+            continue;
+        }
+        float screenRadius = getScreenRadius(ringPositions[i], 1.3f);
+        ringLevels[i] = ringLods.select(ringLevels[i], screenRadius);
+        ringSelection[i] = (uint8_t)(ringLevels[i] + 1);
+    }
+
+    // Only re-stream instances when the ring data, visible set or LOD choice changed
+    if (!ringUploadNeeded && ringSelection == uploadedRingSelection) return;
+
+    for (auto& batch : ringBatches) {
+        batch.instances.clear();
+    }
+    for (size_t i = 0; i < ringInstances.size(); ++i) {
+        if (ringSelection[i]) {
+            ringBatches[ringSelection[i] - 1].instances.push_back(ringInstances[i]);
+        }
+    }
+
+    for (auto& batch : ringBatches) {
+        if (batch.instances.empty()) continue;
+        glBindBuffer(GL_ARRAY_BUFFER, batch.instanceVBO);
+        if (batch.instances.size() > batch.capacity) {
+            // Grow the buffer; smaller updates reuse the existing storage
+            batch.capacity = batch.instances.size();
+            glBufferData(GL_ARRAY_BUFFER, batch.capacity * sizeof(RingInstance), batch.instances.data(), GL_DYNAMIC_DRAW);
+        } else {
+            glBufferSubData(GL_ARRAY_BUFFER, 0, batch.instances.size() * sizeof(RingInstance), batch.instances.data());
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    uploadedRingSelection = ringSelection;
+    ringUploadNeeded = false;
+}
+
 void Renderer::setCameraPosition(float x, float y, float z) {
     view = glm::lookAt(glm::vec3(x, y, z), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
 }
@@ -110,7 +229,22 @@ void Renderer::setDronePosition(float x, float y, float z) {
 
 
 void Renderer::setRingPositions(const std::vector<glm::vec3>& positions) {
+    if (positions == ringPositions) return;
     ringPositions = positions;
+    // A new course: the old rings' LOD levels don't apply
+    ringLevels.clear();
+    ringInstancesDirty = true;
+}
+
+void Renderer::setViewportSize(int width, int height) {
+    (void)width;
+    viewportHeight = height > 0 ? height : 1;
+}
+
+void Renderer::setRingProgress(int ringIndex) {
+    if (ringIndex == currentRingIndex) return;
+    currentRingIndex = ringIndex;
+    ringInstancesDirty = true;
 }
 
 void Renderer::updateCamera(float deltaTime) {
@@ -137,6 +271,7 @@ void Renderer::updateCamera(float deltaTime) {
     }
 
     // Update view matrix
+    cameraPosition = cameraPos;
     view = glm::lookAt(cameraPos, cameraTarget, glm::vec3(0, 1, 0));
 }
 
@@ -165,224 +300,107 @@ void Renderer::resetCamera() {
 }
 
 void Renderer::createShaderProgram() {
-    std::string vertexSource = loadShaderSource("assets/shaders/vertex.glsl");
-    std::string fragmentSource = loadShaderSource("assets/shaders/fragment.glsl");
-
-    if (vertexSource.empty() || fragmentSource.empty()) {
-        std::cerr << "ERROR: Failed to load shader sources. Cannot create shader program." << std::endl;
+    if (!loadShaderProgram(sceneShader, "assets/shaders/vertex.glsl", "assets/shaders/fragment.glsl") ||
+        !loadShaderProgram(ringShader, "assets/shaders/ring_vertex.glsl", "assets/shaders/fragment.glsl")) {
+        LOG_ERROR("Failed to create shader programs");
         return;
     }
 
-    const char* vertexCode = vertexSource.c_str();
-    const char* fragmentCode = fragmentSource.c_str();
+    sceneShader.bindUniformBlock("FrameData", kFrameUniformBinding);
+    ringShader.bindUniformBlock("FrameData", kFrameUniformBinding);
 
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexCode, NULL);
-    glCompileShader(vertexShader);
+    // Resolve per-object uniforms once
+    sceneModelLoc = sceneShader.getUniformLocation("model");
+    sceneObjectColorLoc = sceneShader.getUniformLocation("objectColor");
 
-    // Check for errors
-    int success;
-    char infoLog[512];
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
-    }
+    // Ground and drone share one surface color, so set it once rather than every frame
+    sceneShader.use();
+    glUniform3f(sceneObjectColorLoc, 0.8f, 0.8f, 0.9f); // Brighter, slightly blue-tinted
+    glUseProgram(0);
+}
 
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentCode, NULL);
-    glCompileShader(fragmentShader);
+bool Renderer::loadShaderProgram(ShaderProgram& program, const std::string& vertexPath, const std::string& fragmentPath) {
+    std::string vertexSource = loadShaderSource(vertexPath);
+    std::string fragmentSource = loadShaderSource(fragmentPath);
 
-    // Check for errors
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success) {
-        glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+    if (vertexSource.empty() || fragmentSource.empty()) {
+        LOG_ERROR("Failed to load shader sources. Cannot create shader program.");
+        return false;
     }
 
-    shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-
-    // Check for errors
-    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-    if (!success) {
-        glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
-    }
+    return program.build(vertexSource, fragmentSource, vertexPath);
+}
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+void Renderer::createFrameUniformBuffer() {
+    // Constant lighting is uploaded here once; updateFrameUniforms only refreshes the camera
+    frameUniforms.view = view;
+    frameUniforms.projection = projection;
+    frameUniforms.viewPos = glm::vec4(0.0f, 5.0f, 5.0f, 1.0f);
+    frameUniforms.lightPos = glm::vec4(1.2f, 1.0f, 2.0f, 1.0f);
+    frameUniforms.lightPos2 = glm::vec4(-1.2f, 2.0f, -2.0f, 1.0f); // Secondary light position
+    frameUniforms.lightColor = glm::vec4(1.0f, 1.0f, 1.0f, 0.0f);
+    frameUniforms.lightColor2 = glm::vec4(0.7f, 0.8f, 1.0f, 0.0f); // Softer blue fill light
+
+    glGenBuffers(1, &frameUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), &frameUniforms, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, kFrameUniformBinding, frameUBO);
+    frameUniformsValid = false;
 }
 
 void Renderer::createGroundPlane() {
-    float vertices[] = {
-        // positions          // normals
-        -10.0f, 0.0f, -10.0f,  0.0f, 1.0f, 0.0f,
-         10.0f, 0.0f, -10.0f,  0.0f, 1.0f, 0.0f,
-         10.0f, 0.0f,  10.0f,  0.0f, 1.0f, 0.0f,
-        -10.0f, 0.0f, -10.0f,  0.0f, 1.0f, 0.0f,
-         10.0f, 0.0f,  10.0f,  0.0f, 1.0f, 0.0f,
-        -10.0f, 0.0f,  10.0f,  0.0f, 1.0f, 0.0f
-    };
-
-    glGenVertexArrays(1, &groundVAO);
-    glGenBuffers(1, &groundVBO);
-    glBindVertexArray(groundVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, groundVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    groundMesh = meshes.add("ground", buildGroundPlane(kGroundHalfSize));
 }
 
 void Renderer::createCube() {
-    // Create a smooth sphere for the drone - much more visually appealing and less straining
-    std::vector<float> vertices;
-
-    const int stacks = 16;  // latitude divisions
-    const int slices = 16;  // longitude divisions
-    const float radius = 0.3f; // sphere radius
-
-    for (int i = 0; i <= stacks; ++i) {
-        float phi = 3.14159f * i / stacks; // from 0 to π
-        for (int j = 0; j <= slices; ++j) {
-            float theta = 2.0f * 3.14159f * j / slices; // from 0 to 2π
-
-            // Vertex position
-            float x = radius * sin(phi) * cos(theta);
-            float y = radius * cos(phi);
-            float z = radius * sin(phi) * sin(theta);
-
-            // Normal (same as position for unit sphere)
-            float nx = x / radius;
-            float ny = y / radius;
-            float nz = z / radius;
-
-            // Texture coordinates
-            float u = (float)j / slices;
-            float v = (float)i / stacks;
-
-            vertices.insert(vertices.end(), {x, y, z, nx, ny, nz, u, v});
-        }
+    // Create a smooth sphere for the drone - much more visually appealing and less straining.
+    // Coarser levels take over as the drone shrinks on screen.
+    const int segments[] = {24, 16, 8};
+    const float switchRadii[] = {60.0f, 20.0f};
+    for (int level = 0; level < 3; ++level) {
+        std::string name = "drone_lod" + std::to_string(level);
+        droneLods.levels.push_back(meshes.add(name, buildSphere(0.3f, segments[level], segments[level])));
     }
+    droneLods.switchRadii.assign(switchRadii, switchRadii + 2);
+}
 
-    // Generate indices for triangles
-    std::vector<unsigned int> indices;
-    for (int i = 0; i < stacks; ++i) {
-        for (int j = 0; j < slices; ++j) {
-            unsigned int first = (unsigned int)(i * (slices + 1) + j);
-            unsigned int second = first + slices + 1;
-
-            // Two triangles per quad
-            indices.insert(indices.end(), {first, second, first + 1});
-            indices.insert(indices.end(), {second, second + 1, first + 1});
-        }
+void Renderer::createTorus() {
+    // Distant gates drop to a fraction of the near-level triangle count
+    const int majorSegments[] = {32, 16, 8};
+    const int minorSegments[] = {12, 8, 4};
+    const float switchRadii[] = {80.0f, 25.0f};
+    for (int level = 0; level < 3; ++level) {
+        std::string name = "ring_lod" + std::to_string(level);
+        ringLods.levels.push_back(meshes.add(name, buildTorus(1.0f, 0.3f, majorSegments[level], minorSegments[level])));
     }
-
-    // Create VAO and VBO
-    glGenVertexArrays(1, &cubeVAO);
-    glGenBuffers(1, &cubeVBO);
-    glGenBuffers(1, &torusVBO); // Reuse torusVBO for indices
-
-    glBindVertexArray(cubeVAO);
-
-    // Vertex buffer
-    glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    // Index buffer
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, torusVBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-    // Vertex attributes
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    ringLods.switchRadii.assign(switchRadii, switchRadii + 2);
 }
 
-void Renderer::createTorus() {
-    std::vector<float> vertices;
-    float R = 1.0f; // major radius
-    float r = 0.3f; // minor radius
-    int numMajor = 16;
-    int numMinor = 8;
-
-    for (int i = 0; i < numMajor; ++i) {
-        float theta = 2.0f * 3.14159f * i / numMajor;
-        float nextTheta = 2.0f * 3.14159f * (i + 1) / numMajor;
-
-        for (int j = 0; j < numMinor; ++j) {
-            float phi = 2.0f * 3.14159f * j / numMinor;
-            float nextPhi = 2.0f * 3.14159f * (j + 1) / numMinor;
-
-            // First triangle
-            vertices.push_back((R + r * cos(phi)) * cos(theta));
-            vertices.push_back(r * sin(phi));
-            vertices.push_back((R + r * cos(phi)) * sin(theta));
-            vertices.push_back(cos(theta) * cos(phi));
-            vertices.push_back(sin(phi));
-            vertices.push_back(sin(theta) * cos(phi));
-
-            vertices.push_back((R + r * cos(nextPhi)) * cos(theta));
-            vertices.push_back(r * sin(nextPhi));
-            vertices.push_back((R + r * cos(nextPhi)) * sin(theta));
-            vertices.push_back(cos(theta) * cos(nextPhi));
-            vertices.push_back(sin(nextPhi));
-            vertices.push_back(sin(theta) * cos(nextPhi));
-
-            vertices.push_back((R + r * cos(phi)) * cos(nextTheta));
-            vertices.push_back(r * sin(phi));
-            vertices.push_back((R + r * cos(phi)) * sin(nextTheta));
-            vertices.push_back(cos(nextTheta) * cos(phi));
-            vertices.push_back(sin(phi));
-            vertices.push_back(sin(nextTheta) * cos(phi));
-
-            // Second triangle
-            vertices.push_back((R + r * cos(nextPhi)) * cos(theta));
-            vertices.push_back(r * sin(nextPhi));
-            vertices.push_back((R + r * cos(nextPhi)) * sin(theta));
-            vertices.push_back(cos(theta) * cos(nextPhi));
-            vertices.push_back(sin(nextPhi));
-            vertices.push_back(sin(theta) * cos(nextPhi));
-
-            vertices.push_back((R + r * cos(nextPhi)) * cos(nextTheta));
-            vertices.push_back(r * sin(nextPhi));
-            vertices.push_back((R + r * cos(nextPhi)) * sin(nextTheta));
-            vertices.push_back(cos(nextTheta) * cos(nextPhi));
-            vertices.push_back(sin(nextPhi));
-            vertices.push_back(sin(nextTheta) * cos(nextPhi));
-
-            vertices.push_back((R + r * cos(phi)) * cos(nextTheta));
-            vertices.push_back(r * sin(phi));
-            vertices.push_back((R + r * cos(phi)) * sin(nextTheta));
-            vertices.push_back(cos(nextTheta) * cos(phi));
-            vertices.push_back(sin(phi));
-            vertices.push_back(sin(nextTheta) * cos(phi));
+void Renderer::createRingInstanceBuffer() {
+    // Each ring LOD mesh gets its own instance buffer, attached to its VAO and advancing once per ring
+    ringBatches.resize(ringLods.getLevelCount());
+    for (int level = 0; level < ringLods.getLevelCount(); ++level) {
+        RingLodBatch& batch = ringBatches[level];
+        glGenBuffers(1, &batch.instanceVBO);
+        glBindVertexArray(meshes.get(ringLods.levels[level]).VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, batch.instanceVBO);
+
+        // Model matrix, one vec4 column per attribute slot
+        for (int column = 0; column < 4; ++column) {
+            GLuint location = 3 + column;
+            glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(RingInstance),
+                                  (void*)(offsetof(RingInstance, model) + column * sizeof(glm::vec4)));
+            glEnableVertexAttribArray(location);
+            glVertexAttribDivisor(location, 1);
         }
+
+        // Ring state color
+        glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, sizeof(RingInstance), (void*)offsetof(RingInstance, color));
+        glEnableVertexAttribArray(7);
+        glVertexAttribDivisor(7, 1);
     }
 
-    glGenVertexArrays(1, &torusVAO);
-    glGenBuffers(1, &torusVBO);
-    glBindVertexArray(torusVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, torusVBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 }
@@ -390,17 +408,17 @@ void Renderer::createTorus() {
 std::string Renderer::loadShaderSource(const std::string& path) {
     std::ifstream file(path);
     if (!file.is_open()) {
-        std::cerr << "ERROR: Failed to open shader file: " << path << std::endl;
+        LOG_ERROR("Failed to open shader file: " << path);
         return "";
     }
 
     std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
 
     if (content.empty()) {
-        std::cerr << "ERROR: Shader file is empty or failed to read: " << path << std::endl;
+        LOG_ERROR("Shader file is empty or failed to read: " << path);
         return "";
     }
 
-    std::cout << "Successfully loaded shader: " << path << " (" << content.length() << " characters)" << std::endl;
+    LOG_INFO("Successfully loaded shader: " << path << " (" << content.length() << " characters)");
     return content;
 }
\ No newline at end of file
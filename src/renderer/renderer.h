@@ -8,6 +8,11 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <vector>
 #include <string>
+#include "shader_program.h"
+#include "mesh_registry.h"
+#include "frustum.h"
+#include "lod.h"
+#include "gpu_timer.h"
 
 class Renderer {
 public:
@@ -29,26 +34,91 @@ public:
     float getCameraPitch() const { return cameraPitch; }
     void setDronePosition(float x, float y, float z);
     void setRingPositions(const std::vector<glm::vec3>& positions);
+    void setRingProgress(int currentRingIndex);
+    void setViewportSize(int width, int height);
     const glm::mat4& getViewMatrix() const { return view; }
     const glm::mat4& getProjectionMatrix() const { return projection; }
+    bool isSphereVisible(const glm::vec3& center, float radius);
+    const CullStats& getCullStats() const { return cullStats; }
+    int getSubmittedTriangles() const { return submittedTriangles; }
+    // Optional; scene and ring passes are timed on the GPU when set
+    void setGpuTimer(GpuTimer* timer) { gpuTimer = timer; }
 private:
-    GLuint shaderProgram;
-    GLuint groundVAO, groundVBO;
-    GLuint cubeVAO, cubeVBO;
-    GLuint torusVAO, torusVBO;
+    // Per-ring data streamed to the instanced ring draw
+    struct RingInstance {
+        glm::mat4 model;
+        glm::vec3 color;
+    };
+
+    // std140 layout of the FrameData uniform block
+    struct FrameUniforms {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::vec4 viewPos;
+        glm::vec4 lightPos;
+        glm::vec4 lightPos2;
+        glm::vec4 lightColor;
+        glm::vec4 lightColor2;
+    };
+
+    // Instances of one ring LOD level, drawn with that level's mesh
+    struct RingLodBatch {
+        GLuint instanceVBO = 0;
+        size_t capacity = 0;
+        std::vector<RingInstance> instances;
+    };
+
+    static const GLuint kFrameUniformBinding = 0;
+
+    ShaderProgram sceneShader;
+    ShaderProgram ringShader;
+    GLint sceneModelLoc;
+    GLint sceneObjectColorLoc;
+    GLuint frameUBO;
+    FrameUniforms frameUniforms;
+    bool frameUniformsValid;
+    MeshRegistry meshes;
+    MeshId groundMesh;
+    LodChain droneLods;
+    LodChain ringLods;
+    int droneLevel;
     glm::mat4 view;
     glm::mat4 projection;
     glm::vec3 dronePosition;
     std::vector<glm::vec3> ringPositions;
+    std::vector<RingInstance> ringInstances;
+    std::vector<RingLodBatch> ringBatches;
+    BoundingSpheres ringBounds;
+    std::vector<uint8_t> ringVisibility;
+    std::vector<int> ringLevels;
+    std::vector<uint8_t> ringSelection;
+    std::vector<uint8_t> uploadedRingSelection;
+    int currentRingIndex;
+    bool ringInstancesDirty;
+    bool ringUploadNeeded;
+    Frustum frustum;
+    CullStats cullStats;
+    int submittedTriangles;
+    GpuTimer* gpuTimer;
+    glm::vec3 cameraPosition;
+    int viewportHeight;
     float cameraDistance;
     float cameraAngle;
     float cameraHeight;
     float cameraYaw;
     float cameraPitch;
     void createShaderProgram();
+    bool loadShaderProgram(ShaderProgram& program, const std::string& vertexPath, const std::string& fragmentPath);
+    void createFrameUniformBuffer();
+    void updateFrameUniforms();
     void createGroundPlane();
     void createCube();
     void createTorus();
+    void createRingInstanceBuffer();
+    void updateRingInstances();
+    void cullRings();
+    float getScreenRadius(const glm::vec3& center, float radius) const;
+    void renderRings();
     std::string loadShaderSource(const std::string& path);
 };
 
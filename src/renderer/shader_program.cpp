@@ -0,0 +1,111 @@
+#include "shader_program.h"
+#include <vector>
+#include "logging/logger.h"
+
+ShaderProgram::ShaderProgram() : program(0) {}
+
+ShaderProgram::~ShaderProgram() {
+    if (program) {
+        glDeleteProgram(program);
+    }
+}
+
+bool ShaderProgram::build(const std::string& vertexSource, const std::string& fragmentSource, const std::string& name) {
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource, name);
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource, name);
+    if (!vertexShader || !fragmentShader) {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return false;
+    }
+
+    GLuint linked = glCreateProgram();
+    glAttachShader(linked, vertexShader);
+    glAttachShader(linked, fragmentShader);
+    glLinkProgram(linked);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    // Check for errors
+    int success;
+    char infoLog[512];
+    glGetProgramiv(linked, GL_LINK_STATUS, &success);
+    if (!success) {
+        glGetProgramInfoLog(linked, 512, NULL, infoLog);
+        LOG_ERROR("Shader program linking failed (" << name << ")\n" << infoLog);
+        glDeleteProgram(linked);
+        return false;
+    }
+
+    if (program) {
+        glDeleteProgram(program);
+    }
+    program = linked;
+    cacheUniformLocations();
+    return true;
+}
+
+void ShaderProgram::use() const {
+    glUseProgram(program);
+}
+
+GLint ShaderProgram::getUniformLocation(const std::string& uniformName) const {
+    auto it = uniformLocations.find(uniformName);
+    return it != uniformLocations.end() ? it->second : -1;
+}
+
+void ShaderProgram::bindUniformBlock(const char* blockName, GLuint bindingPoint) {
+    GLuint blockIndex = glGetUniformBlockIndex(program, blockName);
+    if (blockIndex != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, blockIndex, bindingPoint);
+    }
+}
+
+GLuint ShaderProgram::compileShader(GLenum type, const std::string& source, const std::string& name) {
+    const char* code = source.c_str();
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &code, NULL);
+    glCompileShader(shader);
+
+    // Check for errors
+    int success;
+    char infoLog[512];
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        glGetShaderInfoLog(shader, 512, NULL, infoLog);
+        const char* stage = type == GL_VERTEX_SHADER ? "Vertex" : "Fragment";
+        LOG_ERROR(stage << " shader compilation failed (" << name << ")\n" << infoLog);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+void ShaderProgram::cacheUniformLocations() {
+    uniformLocations.clear();
+
+    GLint uniformCount = 0;
+    GLint maxNameLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &uniformCount);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    std::vector<char> nameBuffer(maxNameLength > 0 ? maxNameLength : 1);
+    for (GLint i = 0; i < uniformCount; ++i) {
+        GLint size;
+        GLenum type;
+        GLsizei length;
+        glGetActiveUniform(program, (GLuint)i, (GLsizei)nameBuffer.size(), &length, &size, &type, nameBuffer.data());
+
+        // Members of uniform blocks report -1 and are reached through the block instead
+        std::string uniformName(nameBuffer.data(), length);
+        GLint location = glGetUniformLocation(program, uniformName.c_str());
+        if (location < 0) continue;
+
+        // Arrays are reported as "name[0]"; make the bare name resolvable too
+        uniformLocations[uniformName] = location;
+        size_t bracket = uniformName.find('[');
+        if (bracket != std::string::npos) {
+            uniformLocations[uniformName.substr(0, bracket)] = location;
+        }
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef SHADER_PROGRAM_H
+#define SHADER_PROGRAM_H
+
+#include <glad/glad.h>
+#include <string>
+#include <unordered_map>
+
+// Linked GL program with every active uniform location resolved once at link
+// time. Callers should look locations up during setup and keep the GLint,
+// so nothing on the per-object path goes back to the driver for a name lookup.
+class ShaderProgram {
+public:
+    ShaderProgram();
+    ~ShaderProgram();
+    ShaderProgram(const ShaderProgram&) = delete;
+    ShaderProgram& operator=(const ShaderProgram&) = delete;
+
+    bool build(const std::string& vertexSource, const std::string& fragmentSource, const std::string& name);
+    void use() const;
+    GLuint getId() const { return program; }
+    GLint getUniformLocation(const std::string& uniformName) const;
+    void bindUniformBlock(const char* blockName, GLuint bindingPoint);
+private:
+    GLuint program;
+    std::unordered_map<std::string, GLint> uniformLocations;
+
+    static GLuint compileShader(GLenum type, const std::string& source, const std::string& name);
+    void cacheUniformLocations();
+};
+
+#endif
@@ -0,0 +1,171 @@
+#include "batch_simulation.h"
+#include <algorithm>
+#include <atomic>
+#include "logging/logger.h"
+#include "determinism.h"
+
+BatchSimulation::BatchSimulation() : grainSize(1), deterministic(false) {}
+
+BatchSimulation::~BatchSimulation() {}
+
+bool BatchSimulation::init(int numWorlds, unsigned int numThreads) {
+    if (numWorlds <= 0) {
+        LOG_ERROR("Batch simulation needs at least one world");
+        return false;
+    }
+
+    threadPool.reset(new ThreadPool(numThreads));
+
+    worlds.clear();
+    worlds.reserve(numWorlds);
+    for (int i = 0; i < numWorlds; ++i) {
+        // Each world is a separate allocation so neighbouring worlds never share cache lines
+        std::unique_ptr<World> world(new World());
+        // Each world only flies its primary drone, so don't preallocate a pool per world
+        if (!world->physics.init(1)) {
+            LOG_ERROR("Failed to initialize batch world " << i);
+            worlds.clear();
+            return false;
+        }
+        world->mission.init();
+        worlds.push_back(std::move(world));
+    }
+
+    state.positions.assign(numWorlds * 3, 0.0f);
+    state.velocities.assign(numWorlds * 3, 0.0f);
+    state.ringIndices.assign(numWorlds, 0);
+    state.dones.assign(numWorlds, 0);
+    for (int i = 0; i < numWorlds; ++i) {
+        writeState(i);
+    }
+
+    // A few chunks per thread keeps load balanced without much scheduling overhead
+    grainSize = std::max(1, numWorlds / (int)(threadPool->getThreadCount() * 4));
+
+    LOG_INFO("Batch simulation initialized with " << numWorlds << " worlds on "
+             << threadPool->getThreadCount() << " threads");
+    return true;
+}
+
+const BatchState& BatchSimulation::stepAll(const std::vector<glm::vec3>& actions, float deltaTime) {
+    // One action per world; stepping a subset would silently desync the unstepped worlds
+    if (actions.size() != worlds.size()) {
+        LOG_ERROR("stepAll got " << actions.size() << " actions for " << worlds.size() << " worlds, not stepping");
+        return state;
+    }
+    threadPool->parallelFor((int)worlds.size(), grainSize, [&](int begin, int end) {
+        // Pool threads inherit whatever FP state the process started with; setting it is one register write
+        if (deterministic) setDeterministicFloatEnvironment();
+        for (int i = begin; i < end; ++i) {
+            stepWorld(i, actions[i], deltaTime);
+        }
+    });
+    return state;
+}
+
+void BatchSimulation::resetAll() {
+    threadPool->parallelFor((int)worlds.size(), grainSize, [this](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            resetWorld(i);
+        }
+    });
+}
+
+void BatchSimulation::resetWorld(int index) {
+    World& world = *worlds[index];
+    world.physics.resetDrone();
+    world.mission.reset();
+    state.dones[index] = 0;
+    writeState(index);
+}
+
+void BatchSimulation::saveWorld(int index, WorldSnapshot& snapshot) const {
+    const World& world = *worlds[index];
+    // Physics last, so restoreWorld can validate everything before applying anything
+    SnapshotWriter writer(snapshot);
+    writer.write(state.dones[index]);
+    world.mission.saveState(writer);
+    world.physics.saveState(writer);
+}
+
+bool BatchSimulation::restoreWorld(int index, const WorldSnapshot& snapshot) {
+    World& world = *worlds[index];
+    SnapshotReader reader(snapshot);
+    uint8_t done = 0;
+    bool ok = reader.read(done);
+    SnapshotReader missionReader = reader;
+    if (!ok || !world.mission.checkState(reader) || !world.physics.restoreState(reader)) {
+        LOG_ERROR("Failed to restore batch world " << index);
+        return false;
+    }
+    world.mission.restoreState(missionReader);
+    state.dones[index] = done;
+    writeState(index);
+    return true;
+}
+
+bool BatchSimulation::restoreAll(const WorldSnapshot& snapshot) {
+    std::atomic<int> failures(0);
+    threadPool->parallelFor((int)worlds.size(), grainSize, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            if (!restoreWorld(i, snapshot)) failures.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    return failures.load() == 0;
+}
+
+bool BatchSimulation::setDeterministic(bool enabled) {
+    for (auto& world : worlds) {
+        if (!world->physics.setDeterministic(enabled)) return false;
+    }
+    deterministic = enabled;
+    return true;
+}
+
+uint64_t BatchSimulation::hashWorld(int index) const {
+    WorldSnapshot snapshot;
+    saveWorld(index, snapshot);
+    return hashBytes(snapshot.bytes.data(), snapshot.bytes.size());
+}
+
+int BatchSimulation::getWorldCount() const {
+    return (int)worlds.size();
+}
+
+unsigned int BatchSimulation::getThreadCount() const {
+    return threadPool ? threadPool->getThreadCount() : 0;
+}
+
+void BatchSimulation::stepWorld(int index, const glm::vec3& action, float deltaTime) {
+    if (state.dones[index]) {
+        resetWorld(index);
+    }
+
+    World& world = *worlds[index];
+    world.physics.applyThrust(action);
+    world.physics.stepFixed(deltaTime);
+
+    glm::vec3 dronePos = world.physics.getDronePosition();
+    world.mission.update(dronePos);
+
+    // Same episode end conditions as the interactive loop: crash or course complete
+    bool crashed = dronePos.y < 0;
+    state.dones[index] = (crashed || world.mission.isMissionComplete()) ? 1 : 0;
+    writeState(index);
+}
+
+void BatchSimulation::writeState(int index) {
+    World& world = *worlds[index];
+    glm::vec3 pos = world.physics.getDronePosition();
+    glm::vec3 vel = world.physics.getDroneVelocity();
+
+    float* p = &state.positions[index * 3];
+    p[0] = pos.x;
+    p[1] = pos.y;
+    p[2] = pos.z;
+    float* v = &state.velocities[index * 3];
+    v[0] = vel.x;
+    v[1] = vel.y;
+    v[2] = vel.z;
+    state.ringIndices[index] = world.mission.getCurrentRingIndex();
+}
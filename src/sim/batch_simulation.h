@@ -0,0 +1,61 @@
+#ifndef BATCH_SIMULATION_H
+#define BATCH_SIMULATION_H
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "physics/physics.h"
+#include "mission/mission.h"
+#include "thread_pool.h"
+#include "world_snapshot.h"
+
+// Packed per-world state, indexed by world. Vector fields are xyz interleaved.
+struct BatchState {
+    std::vector<float> positions;
+    std::vector<float> velocities;
+    std::vector<int> ringIndices;
+    std::vector<uint8_t> dones;
+};
+
+// Headless simulation of N independent drone worlds, stepped in parallel.
+// Worlds that report done are reset at the start of the next stepAll so the
+// terminal state can still be observed.
+class BatchSimulation {
+public:
+    BatchSimulation();
+    ~BatchSimulation();
+    bool init(int numWorlds, unsigned int numThreads = 0);
+    // Needs exactly one action per world; otherwise nothing is stepped
+    const BatchState& stepAll(const std::vector<glm::vec3>& actions, float deltaTime);
+    void resetAll();
+    void resetWorld(int index);
+    // Rollouts: save one world (drone bodies and mission progress), then restore it into
+    // any world, or into all of them in parallel to fork rollouts from the same state
+    void saveWorld(int index, WorldSnapshot& snapshot) const;
+    bool restoreWorld(int index, const WorldSnapshot& snapshot);
+    bool restoreAll(const WorldSnapshot& snapshot);
+    // Deterministic stepping (see Physics::setDeterministic); worlds fed the same actions from
+    // the same snapshot then end in the same state, which hashWorld can be used to check or dedupe
+    bool setDeterministic(bool enabled);
+    uint64_t hashWorld(int index) const;
+    int getWorldCount() const;
+    unsigned int getThreadCount() const;
+    const BatchState& getState() const { return state; }
+private:
+    struct World {
+        Physics physics;
+        Mission mission;
+    };
+
+    std::vector<std::unique_ptr<World>> worlds;
+    std::unique_ptr<ThreadPool> threadPool;
+    BatchState state;
+    int grainSize;
+    bool deterministic;
+
+    void stepWorld(int index, const glm::vec3& action, float deltaTime);
+    void writeState(int index);
+};
+
+#endif
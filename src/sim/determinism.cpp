@@ -0,0 +1,53 @@
+#include "determinism.h"
+#include <cfenv>
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define DRONE_HAS_SSE_CSR 1
+#endif
+
+namespace {
+
+uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+}
+
+bool setDeterministicFloatEnvironment() {
+    bool ok = std::fesetround(FE_TONEAREST) == 0;
+#if defined(DRONE_HAS_SSE_CSR)
+    // Default MXCSR: all exceptions masked, round to nearest, FTZ and DAZ off
+    _mm_setcsr(0x1F80);
+#endif
+    return ok;
+}
+
+uint64_t hashBytes(const void* data, size_t size, uint64_t hash) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+RandomStream::RandomStream(uint64_t seed, uint64_t streamId) : state(seed) {
+    // Mix the stream id in through one SplitMix round so neighbouring ids give unrelated sequences
+    uint64_t streamState = streamId;
+    state ^= splitMix64(streamState);
+}
+
+uint64_t RandomStream::nextU64() {
+    return splitMix64(state);
+}
+
+float RandomStream::nextFloat() {
+    return (nextU64() >> 40) / 16777216.0f;
+}
+
+float RandomStream::nextFloat(float min, float max) {
+    return min + (max - min) * nextFloat();
+}
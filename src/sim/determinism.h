@@ -0,0 +1,32 @@
+#ifndef DETERMINISM_H
+#define DETERMINISM_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Puts the calling thread's floating-point unit in the default IEEE state:
+// round to nearest, exceptions masked, denormals kept (no flush-to-zero).
+// Call on every thread that steps a world in deterministic mode.
+bool setDeterministicFloatEnvironment();
+
+// FNV-1a over raw bytes; used for per-tick state hashes
+const uint64_t kStateHashSeed = 14695981039346656037ull;
+uint64_t hashBytes(const void* data, size_t size, uint64_t hash = kStateHashSeed);
+
+// Seeded random numbers (SplitMix64). Independent streams are derived from one
+// run seed and a stream id, so adding a consumer doesn't shift anyone else's sequence.
+//
+//     RandomStream spawns(seed, kSpawnStream);
+//     float x = spawns.nextFloat(-2.0f, 18.0f);
+class RandomStream {
+public:
+    explicit RandomStream(uint64_t seed = 0, uint64_t streamId = 0);
+    uint64_t nextU64();
+    // Uniform in [0, 1), from the top 24 bits
+    float nextFloat();
+    float nextFloat(float min, float max);
+private:
+    uint64_t state;
+};
+
+#endif
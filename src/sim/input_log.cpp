@@ -0,0 +1,81 @@
+#include "input_log.h"
+#include <cstring>
+#include "logging/logger.h"
+
+namespace {
+const char* kInputLogHeader = "tick,thrust_x,thrust_y,thrust_z,flags,state_hash";
+}
+
+InputRecorder::InputRecorder() : file(nullptr) {}
+
+InputRecorder::~InputRecorder() {
+    close();
+}
+
+bool InputRecorder::open(const std::string& path) {
+    close();
+    file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("Failed to open input recording: " << path);
+        return false;
+    }
+    std::fprintf(file, "%s\n", kInputLogHeader);
+    return true;
+}
+
+void InputRecorder::close() {
+    if (!file) return;
+    std::fclose(file);
+    file = nullptr;
+}
+
+void InputRecorder::write(const TickInput& input) {
+    if (!file) return;
+    // %.9g round-trips any float exactly
+    std::fprintf(file, "%llu,%.9g,%.9g,%.9g,%u,%016llx\n", (unsigned long long)input.tick, input.thrust.x,
+                 input.thrust.y, input.thrust.z, (unsigned)input.flags, (unsigned long long)input.stateHash);
+}
+
+InputReplay::InputReplay() : file(nullptr) {}
+
+InputReplay::~InputReplay() {
+    close();
+}
+
+bool InputReplay::open(const std::string& path) {
+    close();
+    file = std::fopen(path.c_str(), "r");
+    if (!file) {
+        LOG_ERROR("Failed to open input replay: " << path);
+        return false;
+    }
+    char header[128];
+    if (!std::fgets(header, sizeof(header), file) || std::strncmp(header, kInputLogHeader, std::strlen(kInputLogHeader)) != 0) {
+        LOG_ERROR(path << " is not an input recording");
+        close();
+        return false;
+    }
+    return true;
+}
+
+void InputReplay::close() {
+    if (!file) return;
+    std::fclose(file);
+    file = nullptr;
+}
+
+bool InputReplay::next(TickInput& input) {
+    if (!file) return false;
+    unsigned long long tick = 0;
+    unsigned long long hash = 0;
+    unsigned flags = 0;
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+    if (std::fscanf(file, "%llu,%f,%f,%f,%u,%llx", &tick, &x, &y, &z, &flags, &hash) != 6) {
+        return false;
+    }
+    input.tick = tick;
+    input.thrust = glm::vec3(x, y, z);
+    input.flags = (uint8_t)flags;
+    input.stateHash = hash;
+    return true;
+}
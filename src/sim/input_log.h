@@ -0,0 +1,56 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+const uint8_t kTickInputReset = 1u << 0;
+const uint8_t kTickInputSave = 1u << 1;
+const uint8_t kTickInputLoad = 1u << 2;
+
+// Input applied at the start of one simulation tick, and the world hash after it
+struct TickInput {
+    uint64_t tick = 0;
+    glm::vec3 thrust = glm::vec3(0.0f);
+    uint8_t flags = 0;
+    uint64_t stateHash = 0;
+};
+
+// Per-tick input stream of a deterministic run, one CSV line per tick:
+// tick,thrust_x,thrust_y,thrust_z,flags,state_hash. Floats are written with
+// enough digits to read back bit-exactly.
+class InputRecorder {
+public:
+    InputRecorder();
+    ~InputRecorder();
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return file != nullptr; }
+    void write(const TickInput& input);
+private:
+    FILE* file;
+};
+
+// Reads an InputRecorder file back in tick order
+class InputReplay {
+public:
+    InputReplay();
+    ~InputReplay();
+    InputReplay(const InputReplay&) = delete;
+    InputReplay& operator=(const InputReplay&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return file != nullptr; }
+    // False at the end of the file or on a malformed line
+    bool next(TickInput& input);
+private:
+    FILE* file;
+};
+
+#endif
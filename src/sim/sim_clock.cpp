@@ -0,0 +1,56 @@
+#include "sim_clock.h"
+#include <algorithm>
+#include <cmath>
+
+SimClock::SimClock(double tickRate, int maxTicksPerFrame)
+    : tickRate(1.0), tickSeconds(1.0), accumulator(0.0), maxTicksPerFrame(1), ticksThisFrame(0), tick(0), droppedTicks(0) {
+    // Same clamping as the setters, whichever path sets the rate
+    setTickRate(tickRate);
+    setMaxTicksPerFrame(maxTicksPerFrame);
+}
+
+void SimClock::setTickRate(double rate) {
+    tickRate = std::max(1.0, rate);
+    tickSeconds = 1.0 / tickRate;
+    accumulator = std::min(accumulator, tickSeconds);
+}
+
+void SimClock::setMaxTicksPerFrame(int maxTicks) {
+    maxTicksPerFrame = std::max(1, maxTicks);
+}
+
+void SimClock::beginFrame(double frameSeconds) {
+    // Negative deltas can come from clock adjustments; ignore them
+    accumulator += std::max(0.0, frameSeconds);
+    ticksThisFrame = 0;
+}
+
+bool SimClock::consumeTick() {
+    if (accumulator < tickSeconds) {
+        return false;
+    }
+
+    if (ticksThisFrame >= maxTicksPerFrame) {
+        // Out of budget: drop the backlog but keep the sub-tick remainder for interpolation
+        double backlog = std::floor(accumulator / tickSeconds);
+        droppedTicks += (uint64_t)backlog;
+        accumulator -= backlog * tickSeconds;
+        return false;
+    }
+
+    accumulator -= tickSeconds;
+    ++tick;
+    ++ticksThisFrame;
+    return true;
+}
+
+void SimClock::reset() {
+    accumulator = 0.0;
+    ticksThisFrame = 0;
+    tick = 0;
+    droppedTicks = 0;
+}
+
+float SimClock::getAlpha() const {
+    return (float)std::min(1.0, accumulator / tickSeconds);
+}
@@ -0,0 +1,37 @@
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+#include <cstdint>
+
+// Fixed-timestep simulation clock. Frame time is banked in an accumulator and
+// paid out in whole ticks, at most maxTicksPerFrame per frame; any backlog past
+// that budget is dropped so a slow frame cannot trigger a catch-up spiral.
+//
+//     clock.beginFrame(frameSeconds);
+//     while (clock.consumeTick()) { physics.stepFixed(clock.getTickSeconds()); }
+//     float alpha = clock.getAlpha();
+class SimClock {
+public:
+    explicit SimClock(double tickRate = 120.0, int maxTicksPerFrame = 8);
+    void setTickRate(double tickRate);
+    void setMaxTicksPerFrame(int maxTicks);
+    void beginFrame(double frameSeconds);
+    bool consumeTick();
+    void reset();
+    uint64_t getTick() const { return tick; }
+    double getTickRate() const { return tickRate; }
+    float getTickSeconds() const { return (float)tickSeconds; }
+    float getAlpha() const;
+    int getTicksThisFrame() const { return ticksThisFrame; }
+    uint64_t getDroppedTicks() const { return droppedTicks; }
+private:
+    double tickRate;
+    double tickSeconds;
+    double accumulator;
+    int maxTicksPerFrame;
+    int ticksThisFrame;
+    uint64_t tick;
+    uint64_t droppedTicks;
+};
+
+#endif
@@ -0,0 +1,310 @@
+#include "sim_thread.h"
+#include <algorithm>
+#include <chrono>
+#include "logging/logger.h"
+#include "profiling/profiler.h"
+#include "determinism.h"
+
+SimulationThread::SimulationThread(Physics& physics, Mission& mission)
+    : physics(physics), mission(mission), inputs(256), running(false), droppedTicks(0),
+      thrust(0.0f), lastDronePosition(0.0f), haveQuickSave(false), loadCount(0), deterministic(false),
+      replayedTicks(0), replayMismatchTick(0), blackBox(nullptr), frameSeconds(0.0f), cpuFrameSeconds(0.0f) {}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+bool SimulationThread::startRecording(const std::string& path) {
+    if (running || !recorder.open(path)) return false;
+    deterministic = true;
+    LOG_INFO("Recording inputs to " << path);
+    return true;
+}
+
+bool SimulationThread::startReplay(const std::string& path) {
+    if (running || !replay.open(path)) return false;
+    deterministic = true;
+    replayedTicks = 0;
+    replayMismatchTick = 0;
+    LOG_INFO("Replaying inputs from " << path);
+    return true;
+}
+
+void SimulationThread::start(double tickRate, int maxTicksPerFrame) {
+    if (running) return;
+
+    clock.setTickRate(tickRate);
+    clock.setMaxTicksPerFrame(maxTicksPerFrame);
+    clock.reset();
+    lastDronePosition = physics.getDronePosition();
+
+    // Publish the initial state so the renderer has something to draw before the first tick
+    publishSnapshot();
+    updateSnapshot();
+
+    running = true;
+    thread = std::thread(&SimulationThread::run, this);
+    LOG_INFO("Simulation thread started at " << clock.getTickRate() << " Hz");
+}
+
+void SimulationThread::stop() {
+    if (!running) return;
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+    if (replay.isOpen()) {
+        finishReplay();
+    }
+    recorder.close();
+}
+
+bool SimulationThread::pushInput(const InputCommand& command) {
+    return inputs.push(command);
+}
+
+bool SimulationThread::updateSnapshot() {
+    return snapshots.update();
+}
+
+float SimulationThread::getInterpolationAlpha() const {
+    const WorldState& snapshot = getSnapshot();
+    if (snapshot.tickSeconds <= 0.0f) return 1.0f;
+    double alpha = (now() - snapshot.publishTime) / snapshot.tickSeconds;
+    return (float)std::min(1.0, std::max(0.0, alpha));
+}
+
+double SimulationThread::now() {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+void SimulationThread::run() {
+    PROFILE_THREAD_NAME("Simulation");
+    if (deterministic && !setDeterministicFloatEnvironment()) {
+        LOG_WARN("Failed to set the floating-point environment; runs may not be reproducible");
+    }
+    double lastTime = now();
+    while (running) {
+        // Drain inputs; only the latest thrust matters but resets, saves and loads must not be lost
+        InputCommand command;
+        while (inputs.pop(command)) {
+            pendingInput.thrust = command.thrust;
+            if (command.resetRequested) pendingInput.flags |= kTickInputReset;
+            if (command.saveRequested) {
+                pendingInput.flags |= kTickInputSave;
+                pendingControllerState.bytes.swap(command.controllerState.bytes);
+            }
+            if (command.loadRequested) pendingInput.flags |= kTickInputLoad;
+            frameSeconds = command.frameSeconds;
+            cpuFrameSeconds = command.cpuFrameSeconds;
+        }
+
+        double currentTime = now();
+        clock.beginFrame(currentTime - lastTime);
+        lastTime = currentTime;
+
+        {
+            std::lock_guard<std::mutex> lock(worldMutex);
+            while (clock.consumeTick()) {
+                tick();
+            }
+            if (clock.getTicksThisFrame() > 0) {
+                publishSnapshot();
+            }
+        }
+        droppedTicks.store(clock.getDroppedTicks(), std::memory_order_relaxed);
+
+        // Sleep until the next tick is due
+        double untilNextTick = (1.0 - clock.getAlpha()) * clock.getTickSeconds();
+        std::this_thread::sleep_for(std::chrono::duration<double>(untilNextTick));
+    }
+}
+
+void SimulationThread::tick() {
+    PROFILE_SCOPE("SimulationThread::tick");
+    LatencyScope latency(tickLatency);
+
+    // Inputs are bound to the tick they're applied on, so a recording replays the same way
+    // no matter how ticks fell across frames
+    TickInput input = pendingInput;
+    input.tick = clock.getTick();
+    pendingInput.flags = 0;
+    uint64_t expectedHash = 0;
+    if (replay.isOpen()) {
+        TickInput recorded;
+        if (replay.next(recorded) && recorded.tick == input.tick) {
+            input = recorded;
+            expectedHash = recorded.stateHash;
+        } else {
+            finishReplay();
+        }
+    }
+
+    thrust = input.thrust;
+    if (input.flags & kTickInputReset) resetWorld();
+    if (input.flags & kTickInputSave) saveWorld();
+    if (input.flags & kTickInputLoad) loadWorld();
+    lastDronePosition = physics.getDronePosition();
+
+    // Forces are cleared after every Bullet step, so thrust is applied per tick
+    physics.applyThrust(thrust);
+    physics.stepFixed(clock.getTickSeconds());
+
+    glm::vec3 dronePos = physics.getDronePosition();
+    mission.update(dronePos);
+
+    // Check for crash (drone below ground)
+    if (dronePos.y < 0) {
+        resetWorld();
+    }
+
+    if (blackBox) recordFlight();
+
+    if (!deterministic) return;
+    input.stateHash = hashWorld();
+    recorder.write(input);
+    if (replay.isOpen()) {
+        ++replayedTicks;
+        if (input.stateHash != expectedHash && replayMismatchTick == 0) {
+            replayMismatchTick = input.tick;
+            LOG_ERROR("Replay diverged at tick " << input.tick);
+        }
+    }
+}
+
+uint64_t SimulationThread::hashWorld() {
+    // Hashes exactly what a snapshot restores
+    SnapshotWriter writer(hashScratch);
+    physics.saveState(writer);
+    mission.saveState(writer);
+    return hashBytes(hashScratch.bytes.data(), hashScratch.bytes.size());
+}
+
+void SimulationThread::finishReplay() {
+    if (replayMismatchTick == 0) {
+        LOG_INFO("Replay finished after " << replayedTicks << " ticks; every state hash matched");
+    } else {
+        LOG_WARN("Replay finished after " << replayedTicks << " ticks; first divergence at tick " << replayMismatchTick);
+    }
+    replay.close();
+}
+
+void SimulationThread::recordFlight() {
+    FlightRecord record = {};
+    uint64_t tick = clock.getTick();
+    // Deterministic runs stamp records with simulation time, like the telemetry log
+    record.timestampNs = deterministic ? (int64_t)(tick * (double)clock.getTickSeconds() * 1e9)
+                                       : std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::system_clock::now().time_since_epoch()).count();
+    record.tick = tick;
+    glm::vec3 position = physics.getDronePosition();
+    glm::vec3 velocity = physics.getDroneVelocity();
+    glm::quat orientation = physics.getDroneOrientation();
+    for (int i = 0; i < 3; ++i) {
+        record.position[i] = position[i];
+        record.velocity[i] = velocity[i];
+        record.thrust[i] = thrust[i];
+    }
+    record.orientation[0] = orientation.x;
+    record.orientation[1] = orientation.y;
+    record.orientation[2] = orientation.z;
+    record.orientation[3] = orientation.w;
+    record.ringIndex = mission.getCurrentRingIndex();
+    record.frameSeconds = frameSeconds;
+    record.cpuFrameSeconds = cpuFrameSeconds;
+    record.flags = mission.isMissionComplete() ? kFlightRecordMissionComplete : 0;
+    blackBox->record(record);
+}
+
+void SimulationThread::resetWorld() {
+    physics.resetDrone();
+    mission.reset();
+    // Don't interpolate across the teleport
+    lastDronePosition = physics.getDronePosition();
+}
+
+void SimulationThread::saveWorld() {
+    // Physics goes last: it validates its whole section before applying it, and everything
+    // before it is read into locals or only checked, so a bad load changes nothing
+    SnapshotWriter writer(quickSave);
+    writer.write(thrust.x);
+    writer.write(thrust.y);
+    writer.write(thrust.z);
+    writer.write((uint32_t)pendingControllerState.bytes.size());
+    writer.writeArray(pendingControllerState.bytes.data(), pendingControllerState.bytes.size());
+    mission.saveState(writer);
+    physics.saveState(writer);
+    haveQuickSave = true;
+    LOG_INFO("World saved (" << quickSave.bytes.size() << " bytes)");
+}
+
+void SimulationThread::loadWorld() {
+    if (!haveQuickSave) {
+        LOG_WARN("No saved world to load");
+        return;
+    }
+    SnapshotReader reader(quickSave);
+    glm::vec3 savedThrust(0.0f);
+    uint32_t controllerBytes = 0;
+    bool ok = reader.read(savedThrust.x) && reader.read(savedThrust.y) && reader.read(savedThrust.z) &&
+              reader.read(controllerBytes) && controllerBytes <= reader.getRemaining();
+    if (ok) {
+        controllerScratch.bytes.resize(controllerBytes);
+        ok = reader.readArray(controllerScratch.bytes.data(), controllerBytes);
+    }
+    // The mission section is only checked until physics has been restored
+    SnapshotReader missionReader = reader;
+    if (!ok || !mission.checkState(reader) || !physics.restoreState(reader)) {
+        LOG_ERROR("Failed to load the saved world");
+        return;
+    }
+    mission.restoreState(missionReader);
+    thrust = savedThrust;
+    loadedControllerState.bytes.swap(controllerScratch.bytes);
+    ++loadCount;
+    // Don't interpolate across the jump
+    lastDronePosition = physics.getDronePosition();
+    LOG_INFO("World loaded");
+}
+
+void SimulationThread::publishSnapshot() {
+    PROFILE_SCOPE("SimulationThread::publishSnapshot");
+    WorldState& state = snapshots.getWriteBuffer();
+    state.tick = clock.getTick();
+    state.publishTime = now();
+    state.tickSeconds = clock.getTickSeconds();
+    state.previousDronePosition = lastDronePosition;
+
+    // One pass over the drone pool; the vectors keep their capacity across publishes
+    size_t maxDrones = (size_t)physics.getMaxDrones();
+    state.dronePositions.resize(3 * maxDrones);
+    state.droneOrientations.resize(4 * maxDrones);
+    state.droneLinearVelocities.resize(3 * maxDrones);
+    state.droneAngularVelocities.resize(3 * maxDrones);
+    state.droneActive.resize(maxDrones);
+    DroneStateBuffers buffers;
+    buffers.positions = state.dronePositions.data();
+    buffers.orientations = state.droneOrientations.data();
+    buffers.linearVelocities = state.droneLinearVelocities.data();
+    buffers.angularVelocities = state.droneAngularVelocities.data();
+    buffers.active = state.droneActive.data();
+    state.droneCount = physics.exportDroneStates(buffers);
+
+    DroneId primary = physics.getPrimaryDrone();
+    const float* position = &state.dronePositions[3 * primary];
+    const float* velocity = &state.droneLinearVelocities[3 * primary];
+    const float* orientation = &state.droneOrientations[4 * primary];
+    state.dronePosition = glm::vec3(position[0], position[1], position[2]);
+    state.droneVelocity = glm::vec3(velocity[0], velocity[1], velocity[2]);
+    state.droneOrientation = glm::quat(orientation[3], orientation[0], orientation[1], orientation[2]);
+    state.currentRingIndex = mission.getCurrentRingIndex();
+    state.totalRings = mission.getTotalRings();
+    state.missionComplete = mission.isMissionComplete();
+    state.ringPositions = mission.getRingPositions();
+    if (state.loadCount != loadCount) {
+        state.loadCount = loadCount;
+        state.loadedControllerState = loadedControllerState;
+    }
+    snapshots.publish();
+}
@@ -0,0 +1,112 @@
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include <glm/glm.hpp>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "physics/physics.h"
+#include "profiling/latency_histogram.h"
+#include "mission/mission.h"
+#include "telemetry/flight_recorder.h"
+#include "input_log.h"
+#include "sim_clock.h"
+#include "spsc_queue.h"
+#include "triple_buffer.h"
+#include "world_snapshot.h"
+#include "world_state.h"
+
+// Input sent from the render/input thread to the simulation thread
+struct InputCommand {
+    glm::vec3 thrust = glm::vec3(0.0f);
+    bool resetRequested = false;
+    // Quick save/load of the whole world (bodies, mission progress, held thrust, controller).
+    // A save carries the controller's snapshot section so it lands in the same buffer and tick.
+    bool saveRequested = false;
+    bool loadRequested = false;
+    WorldSnapshot controllerState;
+    // Render timings of the frame that sent this, copied into flight records
+    float frameSeconds = 0.0f;
+    float cpuFrameSeconds = 0.0f;
+};
+
+// Runs Physics and Mission on a dedicated thread at a fixed tick rate.
+// While running, the thread owns both objects: the render thread only talks
+// to it through pushInput/updateSnapshot, and must wrap any other access in
+// withWorldLocked (used for F1 debug drawing, which starts off).
+// Inputs (including resets, saves and loads) take effect at the start of the next tick.
+class SimulationThread {
+public:
+    SimulationThread(Physics& physics, Mission& mission);
+    ~SimulationThread();
+    // Deterministic mode, set before start: the thread runs in the default FP environment
+    // and hashes the world after every tick. Together with Physics::setDeterministic, the
+    // same per-tick inputs then give bit-identical states on every run.
+    void setDeterministic(bool enabled) { deterministic = enabled; }
+    // Writes every tick's input and state hash (implies deterministic mode)
+    bool startRecording(const std::string& path);
+    // Feeds ticks from a recording instead of pushInput and checks each tick's hash against it;
+    // live input takes over when the recording ends (implies deterministic mode)
+    bool startReplay(const std::string& path);
+    // Set before start: every tick's state goes into the black box. The recorder must outlive the thread.
+    void setFlightRecorder(FlightRecorder* recorder) { blackBox = recorder; }
+    void start(double tickRate, int maxTicksPerFrame);
+    void stop();
+    bool pushInput(const InputCommand& command);
+    bool updateSnapshot();
+    const WorldState& getSnapshot() const { return snapshots.getReadBuffer(); }
+    float getInterpolationAlpha() const;
+    uint64_t getDroppedTicks() const { return droppedTicks.load(std::memory_order_relaxed); }
+    // Cost of each tick; only read this once the thread is stopped
+    const LatencyHistogram& getTickLatency() const { return tickLatency; }
+
+    template <typename Fn>
+    void withWorldLocked(Fn fn) {
+        std::lock_guard<std::mutex> lock(worldMutex);
+        fn();
+    }
+
+    static double now();
+private:
+    Physics& physics;
+    Mission& mission;
+    SimClock clock;
+    SpscQueue<InputCommand> inputs;
+    TripleBuffer<WorldState> snapshots;
+    std::mutex worldMutex;
+    std::thread thread;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> droppedTicks;
+    glm::vec3 thrust;
+    glm::vec3 lastDronePosition;
+    LatencyHistogram tickLatency;
+    WorldSnapshot quickSave;
+    bool haveQuickSave;
+    WorldSnapshot pendingControllerState;
+    WorldSnapshot loadedControllerState;
+    WorldSnapshot controllerScratch;
+    uint64_t loadCount;
+    TickInput pendingInput;
+    bool deterministic;
+    WorldSnapshot hashScratch;
+    InputRecorder recorder;
+    InputReplay replay;
+    uint64_t replayedTicks;
+    uint64_t replayMismatchTick;
+    FlightRecorder* blackBox;
+    float frameSeconds;
+    float cpuFrameSeconds;
+
+    void run();
+    void tick();
+    void resetWorld();
+    void saveWorld();
+    void loadWorld();
+    uint64_t hashWorld();
+    void finishReplay();
+    void recordFlight();
+    void publishSnapshot();
+};
+
+#endif
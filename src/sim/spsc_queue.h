@@ -0,0 +1,73 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Bounded lock-free single-producer/single-consumer queue. Capacity is rounded
+// up to a power of two. push fails instead of blocking when the queue is full.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity)
+        : capacity(roundUpToPowerOfTwo(capacity)), mask(this->capacity - 1), slots(new T[this->capacity]),
+          head(0), cachedTail(0), tail(0), cachedHead(0) {}
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side
+    bool push(const T& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead == capacity) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead == capacity) {
+                return false;
+            }
+        }
+        slots[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T& value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail) {
+                return false;
+            }
+        }
+        value = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called concurrently with push/pop
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+    size_t getCapacity() const { return capacity; }
+private:
+    static size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t capacity;
+    const size_t mask;
+    std::unique_ptr<T[]> slots;
+
+    // Consumer-owned index plus its cached view of the producer
+    alignas(64) std::atomic<size_t> head;
+    size_t cachedTail;
+    // Producer-owned index plus its cached view of the consumer
+    alignas(64) std::atomic<size_t> tail;
+    size_t cachedHead;
+};
+
+#endif
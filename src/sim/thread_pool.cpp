@@ -0,0 +1,83 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned int numThreads)
+    : job(nullptr), jobCount(0), jobGrainSize(1), nextIndex(0), jobGeneration(0), pendingWorkers(0), stopping(false) {
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // The caller acts as the last worker
+    for (unsigned int i = 1; i < numThreads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned int ThreadPool::getThreadCount() const {
+    return static_cast<unsigned int>(workers.size()) + 1;
+}
+
+void ThreadPool::parallelFor(int count, int grainSize, const std::function<void(int begin, int end)>& body) {
+    if (count <= 0) return;
+    grainSize = std::max(1, grainSize);
+
+    // Not worth waking anyone up for a single chunk
+    if (workers.empty() || count <= grainSize) {
+        body(0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &body;
+        jobCount = count;
+        jobGrainSize = grainSize;
+        nextIndex.store(0, std::memory_order_relaxed);
+        pendingWorkers = static_cast<unsigned int>(workers.size());
+        ++jobGeneration;
+    }
+    workAvailable.notify_all();
+
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    workDone.wait(lock, [this] { return pendingWorkers == 0; });
+    job = nullptr;
+}
+
+void ThreadPool::workerLoop() {
+    unsigned int seenGeneration = 0;
+    for (;;) {
+        std::unique_lock<std::mutex> lock(mutex);
+        workAvailable.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+        if (stopping) return;
+        seenGeneration = jobGeneration;
+        lock.unlock();
+
+        runChunks();
+
+        lock.lock();
+        if (--pendingWorkers == 0) {
+            workDone.notify_one();
+        }
+    }
+}
+
+void ThreadPool::runChunks() {
+    // Chunks are claimed dynamically so uneven per-item cost still balances across threads
+    for (;;) {
+        int begin = nextIndex.fetch_add(jobGrainSize, std::memory_order_relaxed);
+        if (begin >= jobCount) break;
+        (*job)(begin, std::min(begin + jobGrainSize, jobCount));
+    }
+}
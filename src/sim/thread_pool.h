@@ -0,0 +1,40 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads for fork/join style parallel loops.
+// The calling thread also takes part in the work, so a pool created with
+// N threads runs N-1 workers. parallelFor is not reentrant.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned int numThreads = 0);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned int getThreadCount() const;
+    void parallelFor(int count, int grainSize, const std::function<void(int begin, int end)>& body);
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable workDone;
+    const std::function<void(int, int)>* job;
+    int jobCount;
+    int jobGrainSize;
+    std::atomic<int> nextIndex;
+    unsigned int jobGeneration;
+    unsigned int pendingWorkers;
+    bool stopping;
+
+    void workerLoop();
+    void runChunks();
+};
+
+#endif
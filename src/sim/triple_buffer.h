@@ -0,0 +1,47 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-producer/single-consumer triple buffer. The producer always
+// has a private slot to write into, the consumer always has a stable slot to
+// read from, and the newest published slot sits in between. Neither side ever
+// blocks; the consumer simply skips snapshots it was too slow to see.
+//
+// The write slot is recycled, so the producer must overwrite every field it
+// publishes rather than patching the previous contents.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle(1), writeIndex(0), readIndex(2) {}
+
+    // Producer side
+    T& getWriteBuffer() { return buffers[writeIndex]; }
+    void publish() {
+        uint8_t previous = middle.exchange(writeIndex | kDirtyBit, std::memory_order_acq_rel);
+        writeIndex = previous & kIndexMask;
+    }
+
+    // Consumer side; returns true if a newer snapshot was picked up
+    bool update() {
+        if ((middle.load(std::memory_order_relaxed) & kDirtyBit) == 0) {
+            return false;
+        }
+        uint8_t previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & kIndexMask;
+        return true;
+    }
+    const T& getReadBuffer() const { return buffers[readIndex]; }
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kDirtyBit = 0x4;
+
+    T buffers[3];
+    // Producer and consumer indices live on separate cache lines from the shared slot
+    alignas(64) std::atomic<uint8_t> middle;
+    alignas(64) uint8_t writeIndex;
+    alignas(64) uint8_t readIndex;
+};
+
+#endif
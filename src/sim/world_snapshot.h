@@ -0,0 +1,79 @@
+#ifndef WORLD_SNAPSHOT_H
+#define WORLD_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Flat byte image of a simulation world. Each object that owns state (Physics,
+// Mission, Controls, SimulationThread) appends a tagged section in saveState and
+// reads it back in the same order in restoreState. This is an in-process format
+// for resets and rollouts, not a file format: values are stored raw.
+struct WorldSnapshot {
+    std::vector<uint8_t> bytes;
+};
+
+// Section tags, four ASCII characters
+inline uint32_t makeSnapshotTag(char a, char b, char c, char d) {
+    return (uint32_t)(uint8_t)a | ((uint32_t)(uint8_t)b << 8) | ((uint32_t)(uint8_t)c << 16) | ((uint32_t)(uint8_t)d << 24);
+}
+
+// Appends to a snapshot. The byte vector is cleared but keeps its capacity,
+// so re-saving into the same snapshot doesn't allocate.
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(WorldSnapshot& snapshot) : bytes(snapshot.bytes) { bytes.clear(); }
+
+    template <typename T>
+    void write(const T& value) { writeArray(&value, 1); }
+
+    template <typename T>
+    void writeArray(const T* values, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Snapshot values must be trivially copyable");
+        if (count == 0) return;
+        size_t offset = bytes.size();
+        bytes.resize(offset + sizeof(T) * count);
+        std::memcpy(&bytes[offset], values, sizeof(T) * count);
+    }
+private:
+    std::vector<uint8_t>& bytes;
+};
+
+// Reads a snapshot front to back. Readers don't modify the snapshot, so many
+// worlds can restore from one snapshot at once (e.g. forking rollouts).
+class SnapshotReader {
+public:
+    explicit SnapshotReader(const WorldSnapshot& snapshot)
+        : cursor(snapshot.bytes.data()), end(snapshot.bytes.data() + snapshot.bytes.size()) {}
+
+    template <typename T>
+    bool read(T& value) { return readArray(&value, 1); }
+
+    template <typename T>
+    bool readArray(T* values, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "Snapshot values must be trivially copyable");
+        size_t size = sizeof(T) * count;
+        if (getRemaining() < size) {
+            cursor = end;
+            return false;
+        }
+        if (size > 0) std::memcpy(values, cursor, size);
+        cursor += size;
+        return true;
+    }
+
+    // Reads a section tag and checks it matches
+    bool expectTag(uint32_t tag) {
+        uint32_t value = 0;
+        return read(value) && value == tag;
+    }
+
+    size_t getRemaining() const { return (size_t)(end - cursor); }
+private:
+    const uint8_t* cursor;
+    const uint8_t* end;
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef WORLD_STATE_H
+#define WORLD_STATE_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cstdint>
+#include <vector>
+#include "world_snapshot.h"
+
+// Snapshot of the world captured at the end of a simulation tick and handed
+// to the render thread
+struct WorldState {
+    uint64_t tick = 0;
+    double publishTime = 0.0;
+    float tickSeconds = 0.0f;
+    glm::vec3 previousDronePosition = glm::vec3(0.0f);
+    glm::vec3 dronePosition = glm::vec3(0.0f);
+    glm::vec3 droneVelocity = glm::vec3(0.0f);
+    glm::quat droneOrientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+    int currentRingIndex = 0;
+    int totalRings = 0;
+    bool missionComplete = false;
+    std::vector<glm::vec3> ringPositions;
+    // Every drone slot in the physics pool, filled in one bulk export (see DroneStateBuffers)
+    int droneCount = 0;
+    std::vector<float> dronePositions;
+    std::vector<float> droneOrientations;
+    std::vector<float> droneLinearVelocities;
+    std::vector<float> droneAngularVelocities;
+    std::vector<uint8_t> droneActive;
+    // Bumped by every quick load; the render thread restores its controller from
+    // loadedControllerState when it sees a new value
+    uint64_t loadCount = 0;
+    WorldSnapshot loadedControllerState;
+};
+
+// Drone position between the last two ticks; alpha is the fraction of a tick elapsed since publishing
+inline glm::vec3 interpolateDronePosition(const WorldState& state, float alpha) {
+    return glm::mix(state.previousDronePosition, state.dronePosition, alpha);
+}
+
+#endif
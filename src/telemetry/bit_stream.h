@@ -0,0 +1,102 @@
+#ifndef BIT_STREAM_H
+#define BIT_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// MSB-first bit packing used by the compressed telemetry columns
+class BitWriter {
+public:
+    BitWriter() : current(0), used(0) {}
+
+    void clear() {
+        bytes.clear();
+        current = 0;
+        used = 0;
+    }
+
+    // Appends the low bitCount bits of value (bitCount <= 64)
+    void write(uint64_t value, int bitCount) {
+        while (bitCount > 0) {
+            int space = 8 - used;
+            int take = bitCount < space ? bitCount : space;
+            uint8_t bits = (uint8_t)((value >> (bitCount - take)) & ((1u << take) - 1));
+            current |= (uint8_t)(bits << (space - take));
+            used += take;
+            bitCount -= take;
+            if (used == 8) {
+                bytes.push_back(current);
+                current = 0;
+                used = 0;
+            }
+        }
+    }
+
+    void writeBit(bool bit) { write(bit ? 1 : 0, 1); }
+
+    // Pads the last partial byte with zeros
+    void finish() {
+        if (used > 0) {
+            bytes.push_back(current);
+            current = 0;
+            used = 0;
+        }
+    }
+
+    const std::vector<uint8_t>& getBytes() const { return bytes; }
+private:
+    std::vector<uint8_t> bytes;
+    uint8_t current;
+    int used;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size)
+        : data(data), size(size), bytePosition(0), buffer(0), bufferedBits(0), overrun(false) {}
+
+    // Reads bitCount bits (<= 64), MSB first
+    uint64_t read(int bitCount) {
+        if (bitCount > 56) {
+            uint64_t high = read(bitCount - 32);
+            return (high << 32) | read(32);
+        }
+        if (bitCount <= 0) return 0;
+
+        if (bufferedBits < bitCount) {
+            refill();
+            if (bufferedBits < bitCount) {
+                overrun = true;
+                bufferedBits = 0;
+                return 0;
+            }
+        }
+        uint64_t value = buffer >> (64 - bitCount);
+        buffer <<= bitCount;
+        bufferedBits -= bitCount;
+        return value;
+    }
+
+    bool readBit() { return read(1) != 0; }
+
+    // True once a read ran past the end of the buffer
+    bool hasOverrun() const { return overrun; }
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t bytePosition;
+    // Next unread bits, left aligned
+    uint64_t buffer;
+    int bufferedBits;
+    bool overrun;
+
+    void refill() {
+        while (bufferedBits <= 56 && bytePosition < size) {
+            buffer |= (uint64_t)data[bytePosition++] << (56 - bufferedBits);
+            bufferedBits += 8;
+        }
+    }
+};
+
+#endif
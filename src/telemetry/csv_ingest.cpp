@@ -0,0 +1,230 @@
+#include "csv_ingest.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "mapped_file.h"
+#include "sim/thread_pool.h"
+
+// The SSE2 path counts and locates matches with __builtin_popcount/__builtin_ctz, so GCC and Clang only
+#if (defined(__SSE2__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+#include <emmintrin.h>
+#define CSV_USE_SSE 1
+#elif defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define CSV_USE_NEON 1
+#endif
+
+namespace {
+
+const size_t kMinSliceBytes = 1 << 20;
+
+size_t countNewlines(const char* data, size_t size) {
+    size_t count = 0;
+    size_t i = 0;
+#if defined(CSV_USE_SSE)
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; i + 16 <= size; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(data + i));
+        count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline)));
+    }
+#elif defined(CSV_USE_NEON)
+    const uint8x16_t newline = vdupq_n_u8('\n');
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t bytes = vld1q_u8((const uint8_t*)(data + i));
+        count += vaddvq_u8(vshrq_n_u8(vceqq_u8(bytes, newline), 7));
+    }
+#endif
+    for (; i < size; ++i) {
+        count += data[i] == '\n';
+    }
+    return count;
+}
+
+// Position of the next '\n' at or after begin, or end
+const char* findNewline(const char* begin, const char* end) {
+    const char* p = begin;
+#if defined(CSV_USE_SSE)
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; p + 16 <= end; p += 16) {
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)p), newline));
+        if (mask) return p + __builtin_ctz(mask);
+    }
+#elif defined(CSV_USE_NEON)
+    const uint8x16_t newline = vdupq_n_u8('\n');
+    for (; p + 16 <= end; p += 16) {
+        uint8x16_t eq = vceqq_u8(vld1q_u8((const uint8_t*)p), newline);
+        if (vmaxvq_u8(eq)) break; // Locate the byte in the scalar tail below
+    }
+#endif
+    for (; p < end; ++p) {
+        if (*p == '\n') return p;
+    }
+    return end;
+}
+
+bool parseFloat(const char*& p, const char* end, float& value) {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    std::from_chars_result result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) return false;
+    p = result.ptr;
+    return true;
+#else
+    // Older standard libraries lack floating-point from_chars; strtof needs a terminated copy
+    char buffer[64];
+    size_t length = 0;
+    while (p + length < end && length < sizeof(buffer) - 1 && p[length] != ',' && p[length] != '\n' &&
+           p[length] != '\r') {
+        ++length;
+    }
+    std::memcpy(buffer, p, length);
+    buffer[length] = '\0';
+    char* parsed = nullptr;
+    value = std::strtof(buffer, &parsed);
+    if (parsed == buffer) return false;
+    p += parsed - buffer;
+    return true;
+#endif
+}
+
+// Parses one line [p, lineEnd) into row; false if it isn't ten numeric fields
+bool parseRow(const char* p, const char* lineEnd, int64_t& timestamp, float* values) {
+    if (lineEnd > p && lineEnd[-1] == '\r') --lineEnd;
+
+    std::from_chars_result result = std::from_chars(p, lineEnd, timestamp);
+    if (result.ec != std::errc()) return false;
+    p = result.ptr;
+    for (int c = 0; c < kTelemetryFloatColumnCount; ++c) {
+        if (p >= lineEnd || *p != ',') return false;
+        ++p;
+        if (!parseFloat(p, lineEnd, values[c])) return false;
+    }
+    return p == lineEnd;
+}
+
+struct Slice {
+    const char* begin;
+    const char* end;
+    size_t firstRow;
+    size_t capacity;
+    size_t written;
+    size_t badRows;
+};
+
+} // namespace
+
+bool parseTelemetryCsv(const char* data, size_t size, TelemetryColumns& out, ThreadPool* pool, CsvIngestStats* stats) {
+    out.clear();
+    const char* begin = data;
+    const char* end = data + size;
+
+    // Skip the header if the first line isn't numeric
+    if (begin < end && !(*begin >= '0' && *begin <= '9') && *begin != '-') {
+        const char* newline = findNewline(begin, end);
+        begin = newline < end ? newline + 1 : end;
+    }
+
+    // Newline-aligned slices, a few per thread so uneven lines still balance
+    int threads = pool ? (int)pool->getThreadCount() : 1;
+    size_t bytes = end - begin;
+    size_t sliceCount = std::max<size_t>(1, std::min<size_t>((size_t)threads * 4, bytes / kMinSliceBytes));
+    std::vector<Slice> slices;
+    const char* sliceBegin = begin;
+    for (size_t i = 0; i < sliceCount && sliceBegin < end; ++i) {
+        const char* sliceEnd = i + 1 == sliceCount ? end : begin + bytes * (i + 1) / sliceCount;
+        if (sliceEnd < sliceBegin) sliceEnd = sliceBegin;
+        if (sliceEnd < end) {
+            const char* newline = findNewline(sliceEnd, end);
+            sliceEnd = newline < end ? newline + 1 : end;
+        }
+        slices.push_back({sliceBegin, sliceEnd, 0, 0, 0, 0});
+        sliceBegin = sliceEnd;
+    }
+
+    auto forEachSlice = [&](const std::function<void(int, int)>& body) {
+        if (pool && slices.size() > 1) {
+            pool->parallelFor((int)slices.size(), 1, body);
+        } else {
+            body(0, (int)slices.size());
+        }
+    };
+
+    // Pass 1: row capacity per slice (lines, counting an unterminated last line)
+    forEachSlice([&](int first, int last) {
+        for (int i = first; i < last; ++i) {
+            Slice& slice = slices[i];
+            slice.capacity = countNewlines(slice.begin, slice.end - slice.begin);
+            if (slice.end > slice.begin && slice.end[-1] != '\n') ++slice.capacity;
+        }
+    });
+    size_t capacity = 0;
+    for (auto& slice : slices) {
+        slice.firstRow = capacity;
+        capacity += slice.capacity;
+    }
+    out.timestamps.resize(capacity);
+    for (auto& column : out.values) {
+        column.resize(capacity);
+    }
+
+    // Pass 2: parse every slice straight into its range of the output columns
+    forEachSlice([&](int first, int last) {
+        for (int i = first; i < last; ++i) {
+            Slice& slice = slices[i];
+            size_t row = slice.firstRow;
+            float values[kTelemetryFloatColumnCount];
+            const char* p = slice.begin;
+            while (p < slice.end) {
+                const char* lineEnd = findNewline(p, slice.end);
+                if (lineEnd > p && !(lineEnd - p == 1 && *p == '\r')) {
+                    int64_t timestamp;
+                    if (parseRow(p, lineEnd, timestamp, values)) {
+                        out.timestamps[row] = timestamp;
+                        for (int c = 0; c < kTelemetryFloatColumnCount; ++c) {
+                            out.values[c][row] = values[c];
+                        }
+                        ++row;
+                    } else {
+                        ++slice.badRows;
+                    }
+                }
+                p = lineEnd + 1;
+            }
+            slice.written = row - slice.firstRow;
+        }
+    });
+
+    // Close gaps left by blank or malformed lines
+    size_t rows = 0;
+    size_t badRows = 0;
+    for (const auto& slice : slices) {
+        if (rows != slice.firstRow && slice.written > 0) {
+            std::memmove(&out.timestamps[rows], &out.timestamps[slice.firstRow], slice.written * sizeof(int64_t));
+            for (auto& column : out.values) {
+                std::memmove(&column[rows], &column[slice.firstRow], slice.written * sizeof(float));
+            }
+        }
+        rows += slice.written;
+        badRows += slice.badRows;
+    }
+    out.timestamps.resize(rows);
+    for (auto& column : out.values) {
+        column.resize(rows);
+    }
+
+    if (stats) {
+        stats->bytes = size;
+        stats->rows = rows;
+        stats->badRows = badRows;
+    }
+    return true;
+}
+
+bool ingestTelemetryCsv(const std::string& path, TelemetryColumns& out, ThreadPool* pool, CsvIngestStats* stats) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    return parseTelemetryCsv((const char*)file.getData(), file.getSize(), out, pool, stats);
+}
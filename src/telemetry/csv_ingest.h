@@ -0,0 +1,27 @@
+#ifndef CSV_INGEST_H
+#define CSV_INGEST_H
+
+#include <cstddef>
+#include <string>
+#include "telemetry_format.h"
+
+class ThreadPool;
+
+struct CsvIngestStats {
+    size_t bytes = 0;
+    size_t rows = 0;
+    // Lines that did not hold ten numeric fields; skipped and left out of the output
+    size_t badRows = 0;
+};
+
+// Bulk loader for drone_log.csv files (timestamp,pos_x,...,thrust_z). The text
+// is split into newline-aligned slices that are parsed concurrently with
+// std::from_chars straight into the output columns. Line boundaries are found
+// with SIMD byte scanning. A header line, if present, is skipped.
+bool parseTelemetryCsv(const char* data, size_t size, TelemetryColumns& out, ThreadPool* pool = nullptr,
+                       CsvIngestStats* stats = nullptr);
+// Memory-maps the file and parses it with parseTelemetryCsv
+bool ingestTelemetryCsv(const std::string& path, TelemetryColumns& out, ThreadPool* pool = nullptr,
+                        CsvIngestStats* stats = nullptr);
+
+#endif
@@ -0,0 +1,143 @@
+#include "flight_recorder.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include "logging/logger.h"
+
+namespace {
+
+const uint32_t kRecorderMagic = 0x58424B42; // "BKBX"
+const uint32_t kRecorderVersion = 1;
+// Header gets its own page so records start page aligned
+const size_t kHeaderSize = 4096;
+// Sequence value of a slot whose payload is being overwritten
+const uint64_t kSlotInProgress = ~0ull;
+
+struct RecorderHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t capacity;
+    uint64_t lastSequence; // Hint only; readers trust the per-slot sequences
+};
+
+std::atomic<uint64_t>& sequenceOf(FlightRecord& record) {
+    static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "atomic sequence must overlay the field");
+    return *reinterpret_cast<std::atomic<uint64_t>*>(&record.sequence);
+}
+
+} // namespace
+
+FlightRecorder::FlightRecorder()
+    : fd(-1), mapping(nullptr), mappingSize(0), records(nullptr), capacity(0), nextSequence(1) {}
+
+FlightRecorder::~FlightRecorder() {
+    close();
+}
+
+bool FlightRecorder::open(const std::string& path, uint32_t capacity) {
+    close();
+    if (capacity == 0) return false;
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open flight recorder file: " << path);
+        return false;
+    }
+
+    // A fresh, zero-filled file: every slot starts empty (sequence 0)
+    mappingSize = kHeaderSize + (size_t)capacity * sizeof(FlightRecord);
+    if (ftruncate(fd, (off_t)mappingSize) != 0) {
+        LOG_ERROR("Failed to size flight recorder file: " << path);
+        close();
+        return false;
+    }
+    void* address = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        LOG_ERROR("Failed to map flight recorder file: " << path);
+        mapping = nullptr;
+        close();
+        return false;
+    }
+    mapping = (uint8_t*)address;
+
+    // Fault every page in now so recording never takes a page fault on the hot path
+    volatile uint8_t* pages = mapping;
+    for (size_t offset = 0; offset < mappingSize; offset += 4096) {
+        pages[offset] = 0;
+    }
+
+    RecorderHeader header = {kRecorderMagic, kRecorderVersion, (uint32_t)sizeof(FlightRecord), capacity, 0};
+    std::memcpy(mapping, &header, sizeof(header));
+    records = (FlightRecord*)(mapping + kHeaderSize);
+    this->capacity = capacity;
+    nextSequence = 1;
+    return true;
+}
+
+void FlightRecorder::close() {
+    if (mapping) {
+        sync();
+        munmap(mapping, mappingSize);
+        mapping = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    records = nullptr;
+    mappingSize = 0;
+    capacity = 0;
+}
+
+void FlightRecorder::record(const FlightRecord& entry) {
+    if (!records) return;
+
+    uint64_t sequence = nextSequence++;
+    FlightRecord& slot = records[(sequence - 1) % capacity];
+    std::atomic<uint64_t>& slotSequence = sequenceOf(slot);
+
+    // Invalidate, write the payload, then publish the sequence
+    slotSequence.store(kSlotInProgress, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy((uint8_t*)&slot + sizeof(uint64_t), (const uint8_t*)&entry + sizeof(uint64_t),
+                sizeof(FlightRecord) - sizeof(uint64_t));
+    slotSequence.store(sequence, std::memory_order_release);
+
+    reinterpret_cast<RecorderHeader*>(mapping)->lastSequence = sequence;
+}
+
+void FlightRecorder::sync() {
+    if (mapping) {
+        msync(mapping, mappingSize, MS_ASYNC);
+    }
+}
+
+bool readFlightRecords(const uint8_t* data, size_t size, std::vector<FlightRecord>& records) {
+    records.clear();
+    if (size < kHeaderSize) return false;
+
+    RecorderHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != kRecorderMagic || header.version != kRecorderVersion ||
+        header.recordSize != sizeof(FlightRecord) || header.capacity == 0 ||
+        kHeaderSize + (size_t)header.capacity * sizeof(FlightRecord) > size) {
+        return false;
+    }
+
+    // A slot is valid if it holds a finished record whose sequence maps back to that slot
+    const FlightRecord* slots = (const FlightRecord*)(data + kHeaderSize);
+    for (uint32_t i = 0; i < header.capacity; ++i) {
+        FlightRecord record;
+        std::memcpy(&record, &slots[i], sizeof(record));
+        if (record.sequence == 0 || record.sequence == kSlotInProgress) continue;
+        if ((record.sequence - 1) % header.capacity != i) continue;
+        records.push_back(record);
+    }
+    std::sort(records.begin(), records.end(),
+              [](const FlightRecord& a, const FlightRecord& b) { return a.sequence < b.sequence; });
+    return true;
+}
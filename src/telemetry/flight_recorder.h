@@ -0,0 +1,66 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One full-rate black box entry. sequence is owned by the recorder.
+struct FlightRecord {
+    uint64_t sequence;
+    int64_t timestampNs;     // Wall clock, for matching against other logs
+    uint64_t tick;           // Simulation tick the state belongs to
+    float position[3];
+    float orientation[4];    // Quaternion x, y, z, w
+    float velocity[3];
+    float thrust[3];
+    int32_t ringIndex;
+    float frameSeconds;      // Render frame interval of the latest input when the tick ran
+    float cpuFrameSeconds;   // CPU time that frame's predecessor spent before swap
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FlightRecord) == 96, "FlightRecord layout is part of the file format");
+
+const uint32_t kFlightRecordMissionComplete = 1u << 0;
+
+// Black box backed by a fixed-size shared file mapping. Records go into a
+// circular buffer of slots; the kernel owns the mapped pages, so everything
+// written survives the process being killed or crashing. Each slot is marked
+// in-progress before its payload is written and stamped with its sequence
+// number afterwards, so a reader never mistakes a torn slot for a valid one.
+class FlightRecorder {
+public:
+    FlightRecorder();
+    ~FlightRecorder();
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    // Creates (or truncates) the file and maps it; capacity is in records
+    bool open(const std::string& path, uint32_t capacity);
+    void close();
+    bool isOpen() const { return records != nullptr; }
+
+    // Single writer. No syscalls or allocation: a 96-byte copy plus two atomic stores.
+    void record(const FlightRecord& entry);
+
+    // Asks the kernel to write dirty pages back (only matters for power loss, not crashes)
+    void sync();
+
+    uint64_t getRecordCount() const { return nextSequence - 1; }
+    uint32_t getCapacity() const { return capacity; }
+private:
+    int fd;
+    uint8_t* mapping;
+    size_t mappingSize;
+    FlightRecord* records;
+    uint32_t capacity;
+    uint64_t nextSequence;
+};
+
+// Returns the valid records of a recorder file in sequence order
+bool readFlightRecords(const uint8_t* data, size_t size, std::vector<FlightRecord>& records);
+
+#endif
@@ -0,0 +1,54 @@
+#include "mapped_file.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "logging/logger.h"
+
+MappedFile::MappedFile() : fd(-1), data(nullptr), size(0) {}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open " << path);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        LOG_ERROR("Failed to stat " << path);
+        close();
+        return false;
+    }
+    size = (size_t)info.st_size;
+    if (size == 0) {
+        return true; // Nothing to map; an empty file is still a valid open
+    }
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+        LOG_ERROR("Failed to map " << path);
+        close();
+        return false;
+    }
+    data = (const uint8_t*)mapping;
+    return true;
+}
+
+void MappedFile::close() {
+    if (data) {
+        munmap((void*)data, size);
+        data = nullptr;
+    }
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    size = 0;
+}
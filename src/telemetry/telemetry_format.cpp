@@ -0,0 +1,392 @@
+#include "telemetry_format.h"
+#include <cstring>
+
+namespace {
+
+const uint32_t kFileMagic = 0x474C5444;  // "DTLG"
+const uint32_t kChunkMagic = 0x4B484354; // "TCHK"
+const uint32_t kIndexMagic = 0x58495444; // "DTIX"
+
+void putU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back((uint8_t)(value >> (8 * i)));
+    }
+}
+
+void putU64(std::vector<uint8_t>& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back((uint8_t)(value >> (8 * i)));
+    }
+}
+
+uint32_t getU32(const uint8_t* p) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= (uint32_t)p[i] << (8 * i);
+    }
+    return value;
+}
+
+uint64_t getU64(const uint8_t* p) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= (uint64_t)p[i] << (8 * i);
+    }
+    return value;
+}
+
+uint32_t floatBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float bitsFloat(uint32_t bits) {
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+int countLeadingZeros(uint32_t value) {
+    int count = 0;
+    for (uint32_t mask = 0x80000000u; mask && !(value & mask); mask >>= 1) {
+        ++count;
+    }
+    return count;
+}
+
+int countTrailingZeros(uint32_t value) {
+    int count = 0;
+    for (uint32_t mask = 1u; mask && !(value & mask); mask <<= 1) {
+        ++count;
+    }
+    return count;
+}
+
+// Delta-of-delta buckets: control prefix, payload bits and bias that maps the range onto unsigned
+struct DodBucket {
+    uint32_t prefix;
+    int prefixBits;
+    int valueBits;
+    int64_t bias;
+};
+
+const DodBucket kDodBuckets[] = {
+    {0x2, 2, 7, 63},    // 10   -> [-63, 64]
+    {0x6, 3, 9, 255},   // 110  -> [-255, 256]
+    {0xE, 4, 12, 2047}, // 1110 -> [-2047, 2048]
+};
+
+void encodeDeltaOfDelta(BitWriter& writer, int64_t dod) {
+    if (dod == 0) {
+        writer.writeBit(false);
+        return;
+    }
+    for (const DodBucket& bucket : kDodBuckets) {
+        if (dod >= -bucket.bias && dod <= bucket.bias + 1) {
+            writer.write(bucket.prefix, bucket.prefixBits);
+            writer.write((uint64_t)(dod + bucket.bias), bucket.valueBits);
+            return;
+        }
+    }
+    writer.write(0xF, 4);
+    writer.write((uint64_t)dod, 64);
+}
+
+int64_t decodeDeltaOfDelta(BitReader& reader) {
+    if (!reader.readBit()) return 0;
+    for (const DodBucket& bucket : kDodBuckets) {
+        if (!reader.readBit()) {
+            return (int64_t)reader.read(bucket.valueBits) - bucket.bias;
+        }
+    }
+    return (int64_t)reader.read(64);
+}
+
+} // namespace
+
+void TelemetryColumns::clear() {
+    timestamps.clear();
+    for (auto& column : values) {
+        column.clear();
+    }
+}
+
+void TelemetryColumns::reserve(size_t count) {
+    timestamps.reserve(count);
+    for (auto& column : values) {
+        column.reserve(count);
+    }
+}
+
+void TelemetryColumns::append(const TelemetrySample& sample) {
+    timestamps.push_back(sample.timestampMs);
+    for (int i = 0; i < 3; ++i) {
+        values[kColumnPosX - 1 + i].push_back(sample.position[i]);
+        values[kColumnVelX - 1 + i].push_back(sample.velocity[i]);
+        values[kColumnThrustX - 1 + i].push_back(sample.thrust[i]);
+    }
+}
+
+TelemetrySample TelemetryColumns::getSample(size_t index) const {
+    TelemetrySample sample;
+    sample.timestampMs = timestamps[index];
+    for (int i = 0; i < 3; ++i) {
+        sample.position[i] = values[kColumnPosX - 1 + i][index];
+        sample.velocity[i] = values[kColumnVelX - 1 + i][index];
+        sample.thrust[i] = values[kColumnThrustX - 1 + i][index];
+    }
+    return sample;
+}
+
+TelemetryChunkEncoder::TelemetryChunkEncoder() {
+    reset();
+}
+
+void TelemetryChunkEncoder::reset() {
+    for (auto& column : columns) {
+        column.clear();
+    }
+    sampleCount = 0;
+    firstTimestamp = 0;
+    lastTimestamp = 0;
+    previousDelta = 0;
+    for (int c = 0; c < kTelemetryFloatColumnCount; ++c) {
+        previousBits[c] = 0;
+        previousLeading[c] = -1;
+        previousTrailing[c] = 0;
+    }
+}
+
+void TelemetryChunkEncoder::addSample(const TelemetrySample& sample) {
+    // Timestamps: first value raw, then delta-of-delta against the running delta
+    BitWriter& timeColumn = columns[kColumnTimestamp];
+    if (sampleCount == 0) {
+        firstTimestamp = sample.timestampMs;
+        timeColumn.write((uint64_t)sample.timestampMs, 64);
+    } else {
+        int64_t delta = sample.timestampMs - lastTimestamp;
+        encodeDeltaOfDelta(timeColumn, delta - previousDelta);
+        previousDelta = delta;
+    }
+    lastTimestamp = sample.timestampMs;
+
+    float values[kTelemetryFloatColumnCount] = {
+        sample.position[0], sample.position[1], sample.position[2],
+        sample.velocity[0], sample.velocity[1], sample.velocity[2],
+        sample.thrust[0], sample.thrust[1], sample.thrust[2]
+    };
+    for (int c = 0; c < kTelemetryFloatColumnCount; ++c) {
+        BitWriter& column = columns[kColumnPosX + c];
+        uint32_t bits = floatBits(values[c]);
+        if (sampleCount == 0) {
+            column.write(bits, 32);
+            previousBits[c] = bits;
+            continue;
+        }
+
+        // Floats: '0' when unchanged, else the XOR's meaningful bits, reusing the previous window when it fits
+        uint32_t x = bits ^ previousBits[c];
+        previousBits[c] = bits;
+        if (x == 0) {
+            column.writeBit(false);
+            continue;
+        }
+        column.writeBit(true);
+        int leading = countLeadingZeros(x);
+        int trailing = countTrailingZeros(x);
+        if (previousLeading[c] >= 0 && leading >= previousLeading[c] && trailing >= previousTrailing[c]) {
+            column.writeBit(false);
+            int meaningful = 32 - previousLeading[c] - previousTrailing[c];
+            column.write(x >> previousTrailing[c], meaningful);
+        } else {
+            int meaningful = 32 - leading - trailing;
+            column.writeBit(true);
+            column.write((uint64_t)leading, 5);
+            column.write((uint64_t)(meaningful - 1), 5);
+            column.write(x >> trailing, meaningful);
+            previousLeading[c] = leading;
+            previousTrailing[c] = trailing;
+        }
+    }
+    ++sampleCount;
+}
+
+void TelemetryChunkEncoder::writeTo(std::vector<uint8_t>& out) {
+    putU32(out, kChunkMagic);
+    putU32(out, sampleCount);
+    putU64(out, (uint64_t)firstTimestamp);
+    putU64(out, (uint64_t)lastTimestamp);
+    for (auto& column : columns) {
+        column.finish();
+        putU32(out, (uint32_t)column.getBytes().size());
+    }
+    for (const auto& column : columns) {
+        out.insert(out.end(), column.getBytes().begin(), column.getBytes().end());
+    }
+    reset();
+}
+
+void writeTelemetryFileHeader(std::vector<uint8_t>& out, uint32_t chunkSamples) {
+    putU32(out, kFileMagic);
+    putU32(out, kTelemetryFormatVersion);
+    putU32(out, chunkSamples);
+    putU32(out, 0);
+}
+
+bool readTelemetryFileHeader(const uint8_t* data, size_t size) {
+    if (size < kTelemetryFileHeaderSize) return false;
+    return getU32(data) == kFileMagic && getU32(data + 4) == kTelemetryFormatVersion;
+}
+
+void writeTelemetryIndex(std::vector<uint8_t>& out, const std::vector<TelemetryChunkInfo>& chunks, uint64_t indexOffset) {
+    for (const auto& chunk : chunks) {
+        putU64(out, chunk.offset);
+        putU64(out, (uint64_t)chunk.firstTimestamp);
+        putU64(out, (uint64_t)chunk.lastTimestamp);
+        putU32(out, chunk.sampleCount);
+        putU32(out, 0);
+    }
+    putU64(out, indexOffset);
+    putU32(out, (uint32_t)chunks.size());
+    putU32(out, kIndexMagic);
+}
+
+bool readTelemetryIndex(const uint8_t* data, size_t size, std::vector<TelemetryChunkInfo>& chunks) {
+    chunks.clear();
+    if (!readTelemetryFileHeader(data, size) || size < kTelemetryFileHeaderSize + kTelemetryTrailerSize) return false;
+
+    const uint8_t* trailer = data + size - kTelemetryTrailerSize;
+    if (getU32(trailer + 12) != kIndexMagic) return false;
+    uint64_t indexOffset = getU64(trailer);
+    uint64_t chunkCount = getU32(trailer + 8);
+    // Range-check the offset first so a corrupt value can't wrap the end computation
+    if (indexOffset < kTelemetryFileHeaderSize || indexOffset > size - kTelemetryTrailerSize ||
+        indexOffset + chunkCount * kTelemetryIndexEntrySize != size - kTelemetryTrailerSize) {
+        return false;
+    }
+
+    chunks.resize(chunkCount);
+    for (size_t i = 0; i < chunkCount; ++i) {
+        const uint8_t* entry = data + indexOffset + i * kTelemetryIndexEntrySize;
+        chunks[i].offset = getU64(entry);
+        chunks[i].firstTimestamp = (int64_t)getU64(entry + 8);
+        chunks[i].lastTimestamp = (int64_t)getU64(entry + 16);
+        chunks[i].sampleCount = getU32(entry + 24);
+        if (chunks[i].offset > indexOffset || indexOffset - chunks[i].offset < kTelemetryChunkHeaderSize) {
+            chunks.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool scanTelemetryChunks(const uint8_t* data, size_t size, std::vector<TelemetryChunkInfo>& chunks) {
+    chunks.clear();
+    if (!readTelemetryFileHeader(data, size)) return false;
+
+    // Stops at the index, the end of the file or the first incomplete chunk
+    uint64_t offset = kTelemetryFileHeaderSize;
+    TelemetryChunkInfo info;
+    size_t chunkBytes = 0;
+    while (readTelemetryChunkInfo(data, size, offset, info, &chunkBytes)) {
+        chunks.push_back(info);
+        offset += chunkBytes;
+    }
+    return true;
+}
+
+bool readTelemetryChunkInfo(const uint8_t* data, size_t size, uint64_t offset, TelemetryChunkInfo& info,
+                            size_t* chunkBytes) {
+    if (offset > size || size - offset < kTelemetryChunkHeaderSize) return false;
+    const uint8_t* header = data + offset;
+    if (getU32(header) != kChunkMagic) return false;
+
+    uint64_t total = kTelemetryChunkHeaderSize;
+    for (int c = 0; c < kTelemetryColumnCount; ++c) {
+        total += getU32(header + 24 + 4 * c);
+    }
+    if (offset + total > size) return false;
+
+    info.offset = offset;
+    info.sampleCount = getU32(header + 4);
+    info.firstTimestamp = (int64_t)getU64(header + 8);
+    info.lastTimestamp = (int64_t)getU64(header + 16);
+    if (chunkBytes) *chunkBytes = (size_t)total;
+    return true;
+}
+
+bool decodeTelemetryChunk(const uint8_t* data, size_t size, uint64_t offset, uint32_t columnMask,
+                          TelemetryColumns& out) {
+    TelemetryChunkInfo info;
+    if (!readTelemetryChunkInfo(data, size, offset, info)) return false;
+
+    const uint8_t* header = data + offset;
+    const uint8_t* column = header + kTelemetryChunkHeaderSize;
+    const uint32_t count = info.sampleCount;
+    // The timestamp column spends 64 bits on the first sample and at least one on each
+    // later one; a larger count is corrupt and would only size the output from garbage
+    uint64_t timestampBits = (uint64_t)getU32(header + 24 + 4 * kColumnTimestamp) * 8;
+    if (count > 0 && timestampBits < 64 + (uint64_t)(count - 1)) return false;
+    size_t base = out.size();
+    bool ok = true;
+
+    for (int c = 0; c < kTelemetryColumnCount; ++c) {
+        uint32_t columnBytes = getU32(header + 24 + 4 * c);
+        const uint8_t* columnData = column;
+        column += columnBytes;
+        if (c != kColumnTimestamp && !(columnMask & (1u << c))) continue;
+
+        BitReader reader(columnData, columnBytes);
+        if (c == kColumnTimestamp) {
+            out.timestamps.resize(base + count);
+            int64_t* timestamps = out.timestamps.data() + base;
+            int64_t previous = 0;
+            int64_t delta = 0;
+            for (uint32_t i = 0; i < count; ++i) {
+                if (i == 0) {
+                    previous = (int64_t)reader.read(64);
+                } else {
+                    delta += decodeDeltaOfDelta(reader);
+                    previous += delta;
+                }
+                timestamps[i] = previous;
+            }
+        } else {
+            std::vector<float>& values = out.values[c - 1];
+            values.resize(base + count);
+            float* dst = values.data() + base;
+            uint32_t bits = 0;
+            int leading = 0;
+            int trailing = 0;
+            for (uint32_t i = 0; i < count; ++i) {
+                if (i == 0) {
+                    bits = (uint32_t)reader.read(32);
+                } else if (reader.readBit()) {
+                    if (reader.readBit()) {
+                        leading = (int)reader.read(5);
+                        int meaningful = (int)reader.read(5) + 1;
+                        trailing = 32 - leading - meaningful;
+                        if (trailing < 0) {
+                            ok = false;
+                            break;
+                        }
+                    }
+                    int meaningful = 32 - leading - trailing;
+                    bits ^= (uint32_t)reader.read(meaningful) << trailing;
+                }
+                dst[i] = bitsFloat(bits);
+            }
+        }
+        ok = ok && !reader.hasOverrun();
+    }
+
+    if (!ok) {
+        // Leave the output as it was rather than half-appended
+        out.timestamps.resize(base);
+        for (auto& values : out.values) {
+            if (values.size() > base) values.resize(base);
+        }
+    }
+    return ok;
+}
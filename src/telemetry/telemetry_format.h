@@ -0,0 +1,102 @@
+#ifndef TELEMETRY_FORMAT_H
+#define TELEMETRY_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "telemetry_sample.h"
+#include "bit_stream.h"
+
+// Binary columnar flight log (.dtl)
+//
+//   file header   magic "DTLG", version, samples per chunk, reserved      (16 bytes)
+//   chunk*        chunk header (64 bytes) followed by one compressed bit stream per column
+//   index         one entry per chunk: offset, first/last timestamp, sample count (32 bytes each)
+//   trailer       index offset, chunk count, magic "DTIX"                    (16 bytes)
+//
+// Timestamps are delta-of-delta coded and float columns are XOR coded against
+// the previous value (Gorilla). Each column is byte aligned and its size is in
+// the chunk header, so readers can decode only the columns they need. All
+// integers are little-endian. A file cut short by a crash has no trailer; its
+// complete chunks can still be found with scanTelemetryChunks.
+
+enum TelemetryColumn {
+    kColumnTimestamp = 0,
+    kColumnPosX, kColumnPosY, kColumnPosZ,
+    kColumnVelX, kColumnVelY, kColumnVelZ,
+    kColumnThrustX, kColumnThrustY, kColumnThrustZ,
+    kTelemetryColumnCount
+};
+
+const int kTelemetryFloatColumnCount = kTelemetryColumnCount - 1;
+const uint32_t kAllTelemetryColumns = (1u << kTelemetryColumnCount) - 1;
+const uint32_t kTelemetryFormatVersion = 1;
+const uint32_t kDefaultTelemetryChunkSamples = 4096;
+const size_t kTelemetryFileHeaderSize = 16;
+const size_t kTelemetryChunkHeaderSize = 24 + 4 * kTelemetryColumnCount;
+const size_t kTelemetryIndexEntrySize = 32;
+const size_t kTelemetryTrailerSize = 16;
+
+// Structure-of-arrays view of decoded samples. values[c] holds float column
+// kColumnPosX + c and is only filled for columns that were requested.
+struct TelemetryColumns {
+    std::vector<int64_t> timestamps;
+    std::vector<float> values[kTelemetryFloatColumnCount];
+
+    size_t size() const { return timestamps.size(); }
+    void clear();
+    void reserve(size_t count);
+    void append(const TelemetrySample& sample);
+    // Requires all columns to have been decoded
+    TelemetrySample getSample(size_t index) const;
+};
+
+struct TelemetryChunkInfo {
+    uint64_t offset;
+    int64_t firstTimestamp;
+    int64_t lastTimestamp;
+    uint32_t sampleCount;
+};
+
+// Streams samples into per-column bit streams; writeTo emits a complete chunk
+class TelemetryChunkEncoder {
+public:
+    TelemetryChunkEncoder();
+
+    void addSample(const TelemetrySample& sample);
+    uint32_t getSampleCount() const { return sampleCount; }
+    int64_t getFirstTimestamp() const { return firstTimestamp; }
+    int64_t getLastTimestamp() const { return lastTimestamp; }
+
+    // Appends header plus column data to out and resets the encoder
+    void writeTo(std::vector<uint8_t>& out);
+    void reset();
+private:
+    BitWriter columns[kTelemetryColumnCount];
+    uint32_t sampleCount;
+    int64_t firstTimestamp;
+    int64_t lastTimestamp;
+    int64_t previousDelta;
+    uint32_t previousBits[kTelemetryFloatColumnCount];
+    int previousLeading[kTelemetryFloatColumnCount];
+    int previousTrailing[kTelemetryFloatColumnCount];
+};
+
+void writeTelemetryFileHeader(std::vector<uint8_t>& out, uint32_t chunkSamples);
+bool readTelemetryFileHeader(const uint8_t* data, size_t size);
+
+// Appends the chunk index and trailer; indexOffset is where the index starts in the file
+void writeTelemetryIndex(std::vector<uint8_t>& out, const std::vector<TelemetryChunkInfo>& chunks, uint64_t indexOffset);
+// Reads the index from the trailer; false if the file has none or it is damaged
+bool readTelemetryIndex(const uint8_t* data, size_t size, std::vector<TelemetryChunkInfo>& chunks);
+// Rebuilds the index by walking chunk headers from the start of the file
+bool scanTelemetryChunks(const uint8_t* data, size_t size, std::vector<TelemetryChunkInfo>& chunks);
+
+// Parses the chunk header at offset; chunkBytes receives the full chunk size
+bool readTelemetryChunkInfo(const uint8_t* data, size_t size, uint64_t offset, TelemetryChunkInfo& info,
+                            size_t* chunkBytes = nullptr);
+// Appends the requested columns of the chunk at offset (timestamps are always decoded)
+bool decodeTelemetryChunk(const uint8_t* data, size_t size, uint64_t offset, uint32_t columnMask,
+                          TelemetryColumns& out);
+
+#endif
@@ -0,0 +1,122 @@
+#include "telemetry_reader.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include "sim/thread_pool.h"
+#include "logging/logger.h"
+
+TelemetryReader::TelemetryReader() : sampleCount(0), indexRebuilt(false) {}
+
+bool TelemetryReader::open(const std::string& path) {
+    close();
+    if (!file.open(path)) {
+        return false;
+    }
+
+    const uint8_t* data = file.getData();
+    size_t size = file.getSize();
+    if (!readTelemetryFileHeader(data, size)) {
+        LOG_ERROR(path << " is not a telemetry log");
+        close();
+        return false;
+    }
+    if (!readTelemetryIndex(data, size, chunks)) {
+        scanTelemetryChunks(data, size, chunks);
+        indexRebuilt = true;
+    }
+
+    for (const auto& chunk : chunks) {
+        sampleCount += chunk.sampleCount;
+    }
+    return true;
+}
+
+void TelemetryReader::close() {
+    file.close();
+    chunks.clear();
+    sampleCount = 0;
+    indexRebuilt = false;
+}
+
+int64_t TelemetryReader::getStartTime() const {
+    return chunks.empty() ? 0 : chunks.front().firstTimestamp;
+}
+
+int64_t TelemetryReader::getEndTime() const {
+    return chunks.empty() ? 0 : chunks.back().lastTimestamp;
+}
+
+void TelemetryReader::findChunks(int64_t t0, int64_t t1, size_t& first, size_t& last) const {
+    // First chunk ending at or after t0, and the first chunk starting after t1
+    auto begin = std::lower_bound(chunks.begin(), chunks.end(), t0,
+                                  [](const TelemetryChunkInfo& chunk, int64_t t) { return chunk.lastTimestamp < t; });
+    auto end = std::upper_bound(begin, chunks.end(), t1,
+                                [](int64_t t, const TelemetryChunkInfo& chunk) { return t < chunk.firstTimestamp; });
+    first = begin - chunks.begin();
+    last = end - chunks.begin();
+}
+
+bool TelemetryReader::query(int64_t t0, int64_t t1, uint32_t columnMask, TelemetryColumns& out, ThreadPool* pool) {
+    out.clear();
+    if (t1 < t0) return true;
+
+    size_t first, last;
+    findChunks(t0, t1, first, last);
+    const int count = (int)(last - first);
+    if (count == 0) return true;
+
+    // Decode each chunk into its own buffer; buffers are kept across queries to avoid reallocating
+    if (decodedChunks.size() < (size_t)count) {
+        decodedChunks.resize(count);
+    }
+    std::atomic<bool> ok(true);
+    auto decodeRange = [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            TelemetryColumns& columns = decodedChunks[i];
+            columns.clear();
+            if (!decodeTelemetryChunk(file.getData(), file.getSize(), chunks[first + i].offset, columnMask, columns)) {
+                ok = false;
+            }
+        }
+    };
+    if (pool && count > 1) {
+        pool->parallelFor(count, 1, decodeRange);
+    } else {
+        decodeRange(0, count);
+    }
+    if (!ok) {
+        LOG_ERROR("Corrupt chunk in telemetry range query");
+        return false;
+    }
+
+    // Trim the boundary chunks to [t0, t1] and concatenate in time order
+    std::vector<size_t> begins(count), ends(count);
+    size_t total = 0;
+    for (int i = 0; i < count; ++i) {
+        const std::vector<int64_t>& timestamps = decodedChunks[i].timestamps;
+        begins[i] = std::lower_bound(timestamps.begin(), timestamps.end(), t0) - timestamps.begin();
+        ends[i] = std::upper_bound(timestamps.begin(), timestamps.end(), t1) - timestamps.begin();
+        total += ends[i] - begins[i];
+    }
+
+    out.timestamps.resize(total);
+    for (int c = 0; c < kTelemetryFloatColumnCount; ++c) {
+        if (columnMask & (1u << (kColumnPosX + c))) {
+            out.values[c].resize(total);
+        }
+    }
+    size_t offset = 0;
+    for (int i = 0; i < count; ++i) {
+        const TelemetryColumns& columns = decodedChunks[i];
+        size_t n = ends[i] - begins[i];
+        if (n == 0) continue;
+        std::memcpy(out.timestamps.data() + offset, columns.timestamps.data() + begins[i], n * sizeof(int64_t));
+        for (int c = 0; c < kTelemetryFloatColumnCount; ++c) {
+            if (columnMask & (1u << (kColumnPosX + c))) {
+                std::memcpy(out.values[c].data() + offset, columns.values[c].data() + begins[i], n * sizeof(float));
+            }
+        }
+        offset += n;
+    }
+    return true;
+}
@@ -0,0 +1,46 @@
+#ifndef TELEMETRY_READER_H
+#define TELEMETRY_READER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+#include "telemetry_format.h"
+
+class ThreadPool;
+
+// Random-access reader for .dtl flight logs. Opening maps the file and loads the
+// chunk index from the footer, or rebuilds it from the chunk headers when the
+// footer is missing (a log cut short by a crash). Only the index is touched on
+// open; sample data is decoded on demand. Timestamps are assumed to be
+// non-decreasing, which holds for logs written by TelemetryWriter.
+class TelemetryReader {
+public:
+    TelemetryReader();
+
+    bool open(const std::string& path);
+    void close();
+
+    const std::vector<TelemetryChunkInfo>& getChunks() const { return chunks; }
+    uint64_t getSampleCount() const { return sampleCount; }
+    int64_t getStartTime() const;
+    int64_t getEndTime() const;
+    size_t getFileSize() const { return file.getSize(); }
+    bool wasIndexRebuilt() const { return indexRebuilt; }
+
+    // Index range [first, last) of chunks that may hold samples in [t0, t1]
+    void findChunks(int64_t t0, int64_t t1, size_t& first, size_t& last) const;
+
+    // Replaces out with the samples whose timestamp lies in [t0, t1], decoding only
+    // the overlapping chunks and the requested columns. Chunks are decoded in
+    // parallel when a pool is given.
+    bool query(int64_t t0, int64_t t1, uint32_t columnMask, TelemetryColumns& out, ThreadPool* pool = nullptr);
+private:
+    MappedFile file;
+    std::vector<TelemetryChunkInfo> chunks;
+    uint64_t sampleCount;
+    bool indexRebuilt;
+    std::vector<TelemetryColumns> decodedChunks;
+};
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef TELEMETRY_SAMPLE_H
+#define TELEMETRY_SAMPLE_H
+
+#include <cstdint>
+
+// One flight log record, kept trivially copyable so it can cross thread
+// boundaries by value. Field order matches the drone_log.csv columns.
+struct TelemetrySample {
+    int64_t timestampMs;
+    float position[3];
+    float velocity[3];
+    float thrust[3];
+};
+
+// Column header of the CSV log schema
+extern const char* const kTelemetryCsvHeader;
+
+#endif
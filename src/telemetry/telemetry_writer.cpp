@@ -0,0 +1,209 @@
+#include "telemetry_writer.h"
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include "logging/logger.h"
+
+const char* const kTelemetryCsvHeader = "timestamp,pos_x,pos_y,pos_z,vel_x,vel_y,vel_z,thrust_x,thrust_y,thrust_z";
+
+bool CsvTelemetrySink::open(const std::string& path) {
+    file.open(path, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << kTelemetryCsvHeader << "\n";
+    text.reserve(1 << 16);
+    return true;
+}
+
+void CsvTelemetrySink::write(const TelemetrySample* samples, size_t count) {
+    // Same "%f" formatting std::to_string used, without a string per field
+    char line[256];
+    text.clear();
+    for (size_t i = 0; i < count; ++i) {
+        const TelemetrySample& s = samples[i];
+        int length = std::snprintf(line, sizeof(line), "%" PRId64 ",%f,%f,%f,%f,%f,%f,%f,%f,%f\n", s.timestampMs,
+                                   s.position[0], s.position[1], s.position[2],
+                                   s.velocity[0], s.velocity[1], s.velocity[2],
+                                   s.thrust[0], s.thrust[1], s.thrust[2]);
+        if (length > 0) {
+            text.append(line, length < (int)sizeof(line) ? length : (int)sizeof(line) - 1);
+        }
+    }
+    file.write(text.data(), text.size());
+}
+
+void CsvTelemetrySink::flush() {
+    file.flush();
+}
+
+void CsvTelemetrySink::close() {
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+BinaryTelemetrySink::BinaryTelemetrySink(uint32_t chunkSamples)
+    : chunkSamples(chunkSamples > 0 ? chunkSamples : kDefaultTelemetryChunkSamples), fileOffset(0) {}
+
+bool BinaryTelemetrySink::open(const std::string& path) {
+    file.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    bytes.clear();
+    writeTelemetryFileHeader(bytes, chunkSamples);
+    file.write((const char*)bytes.data(), bytes.size());
+    fileOffset = bytes.size();
+    chunks.clear();
+    encoder.reset();
+    return true;
+}
+
+void BinaryTelemetrySink::write(const TelemetrySample* samples, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        encoder.addSample(samples[i]);
+        if (encoder.getSampleCount() >= chunkSamples) {
+            writeChunk();
+        }
+    }
+}
+
+void BinaryTelemetrySink::writeChunk() {
+    TelemetryChunkInfo info;
+    info.offset = fileOffset;
+    info.firstTimestamp = encoder.getFirstTimestamp();
+    info.lastTimestamp = encoder.getLastTimestamp();
+    info.sampleCount = encoder.getSampleCount();
+
+    bytes.clear();
+    encoder.writeTo(bytes);
+    file.write((const char*)bytes.data(), bytes.size());
+    fileOffset += bytes.size();
+    chunks.push_back(info);
+}
+
+void BinaryTelemetrySink::flush() {
+    // Only completed chunks reach the file; the open chunk stays in memory until it fills
+    file.flush();
+}
+
+void BinaryTelemetrySink::close() {
+    if (!file.is_open()) return;
+
+    if (encoder.getSampleCount() > 0) {
+        writeChunk();
+    }
+    bytes.clear();
+    writeTelemetryIndex(bytes, chunks, fileOffset);
+    file.write((const char*)bytes.data(), bytes.size());
+    file.close();
+}
+
+TelemetryWriter::TelemetryWriter()
+    : stopRequested(false), wakeRequested(false), running(false), flushIntervalMs(100), pushedSamples(0), writtenSamples(0),
+      droppedSamples(0), queueHighWater(0) {}
+
+TelemetryWriter::~TelemetryWriter() {
+    stop();
+}
+
+bool TelemetryWriter::start(const std::string& path, std::unique_ptr<TelemetrySink> sink,
+                            size_t queueCapacity, int flushIntervalMs) {
+    if (running) return false;
+
+    try {
+        if (!sink || !sink->open(path)) {
+            LOG_ERROR("Failed to open telemetry log: " << path);
+            return false;
+        }
+        this->sink = std::move(sink);
+        this->flushIntervalMs = flushIntervalMs;
+        queue.reset(new SpscQueue<TelemetrySample>(queueCapacity));
+        stopRequested = false;
+        wakeRequested = false;
+        thread = std::thread(&TelemetryWriter::run, this);
+        running = true;
+        return true;
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to start telemetry writer: " << e.what());
+        return false;
+    }
+}
+
+void TelemetryWriter::stop() {
+    if (!running) return;
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopRequested = true;
+    }
+    wakeCondition.notify_one();
+    thread.join();
+    sink->close();
+    running = false;
+}
+
+bool TelemetryWriter::push(const TelemetrySample& sample) {
+    if (!queue) return false;
+
+    if (!queue->push(sample)) {
+        droppedSamples.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    pushedSamples.fetch_add(1, std::memory_order_relaxed);
+
+    // Track how close the writer came to falling behind; wake it early once the queue is half full
+    size_t queued = queue->size();
+    if (queued > queueHighWater.load(std::memory_order_relaxed)) {
+        queueHighWater.store(queued, std::memory_order_relaxed);
+    }
+    if (queued >= queue->getCapacity() / 2 && !wakeRequested.exchange(true, std::memory_order_relaxed)) {
+        // Once per wakeup; taking the mutex keeps the notify from landing between the writer's check and its wait
+        { std::lock_guard<std::mutex> lock(wakeMutex); }
+        wakeCondition.notify_one();
+    }
+    return true;
+}
+
+size_t TelemetryWriter::drainBatch(std::vector<TelemetrySample>& batch) {
+    batch.clear();
+    TelemetrySample sample;
+    while (batch.size() < kBatchSize && queue->pop(sample)) {
+        batch.push_back(sample);
+    }
+    if (!batch.empty()) {
+        sink->write(batch.data(), batch.size());
+        writtenSamples.fetch_add(batch.size(), std::memory_order_relaxed);
+    }
+    return batch.size();
+}
+
+void TelemetryWriter::run() {
+    std::vector<TelemetrySample> batch;
+    batch.reserve(kBatchSize);
+
+    while (!stopRequested.load()) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCondition.wait_for(lock, std::chrono::milliseconds(flushIntervalMs),
+                                   [this] { return stopRequested.load() || wakeRequested.load(); });
+        }
+        wakeRequested.store(false, std::memory_order_relaxed);
+
+        // Write everything queued so far, then flush once per wakeup
+        size_t written = 0;
+        size_t count;
+        while ((count = drainBatch(batch)) > 0) {
+            written += count;
+        }
+        if (written > 0) {
+            sink->flush();
+        }
+    }
+
+    // Final drain after the producer has stopped
+    while (drainBatch(batch) > 0) {
+    }
+    sink->flush();
+}
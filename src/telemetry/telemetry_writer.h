@@ -0,0 +1,103 @@
+#ifndef TELEMETRY_WRITER_H
+#define TELEMETRY_WRITER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "telemetry_sample.h"
+#include "telemetry_format.h"
+#include "sim/spsc_queue.h"
+
+// Output format for a batch of samples; called only from the writer thread
+class TelemetrySink {
+public:
+    virtual ~TelemetrySink() {}
+    virtual bool open(const std::string& path) = 0;
+    virtual void write(const TelemetrySample* samples, size_t count) = 0;
+    virtual void flush() = 0;
+    virtual void close() = 0;
+};
+
+// Text output in the drone_log.csv schema
+class CsvTelemetrySink : public TelemetrySink {
+public:
+    bool open(const std::string& path) override;
+    void write(const TelemetrySample* samples, size_t count) override;
+    void flush() override;
+    void close() override;
+private:
+    std::ofstream file;
+    std::string text;
+};
+
+// Chunked columnar binary output (see telemetry_format.h). Chunks are written
+// as they fill; the chunk index is appended when the sink is closed.
+class BinaryTelemetrySink : public TelemetrySink {
+public:
+    explicit BinaryTelemetrySink(uint32_t chunkSamples = kDefaultTelemetryChunkSamples);
+    bool open(const std::string& path) override;
+    void write(const TelemetrySample* samples, size_t count) override;
+    void flush() override;
+    void close() override;
+private:
+    std::ofstream file;
+    uint32_t chunkSamples;
+    uint64_t fileOffset;
+    TelemetryChunkEncoder encoder;
+    std::vector<TelemetryChunkInfo> chunks;
+    std::vector<uint8_t> bytes;
+
+    void writeChunk();
+};
+
+// Moves samples off the producing thread: push copies a fixed-size record into
+// a bounded lock-free queue and never blocks. A background thread drains the
+// queue in batches into the sink. When the writer falls behind and the queue is
+// full, new samples are dropped and counted rather than stalling the producer.
+class TelemetryWriter {
+public:
+    TelemetryWriter();
+    ~TelemetryWriter();
+
+    bool start(const std::string& path, std::unique_ptr<TelemetrySink> sink,
+               size_t queueCapacity = 16384, int flushIntervalMs = 100);
+    // Drains everything still queued, then closes the sink
+    void stop();
+    bool isRunning() const { return running; }
+
+    // Producer side (single thread)
+    bool push(const TelemetrySample& sample);
+
+    uint64_t getPushedCount() const { return pushedSamples.load(std::memory_order_relaxed); }
+    uint64_t getWrittenCount() const { return writtenSamples.load(std::memory_order_relaxed); }
+    uint64_t getDroppedCount() const { return droppedSamples.load(std::memory_order_relaxed); }
+    size_t getQueueHighWater() const { return queueHighWater.load(std::memory_order_relaxed); }
+private:
+    static const size_t kBatchSize = 1024;
+
+    std::unique_ptr<SpscQueue<TelemetrySample>> queue;
+    std::unique_ptr<TelemetrySink> sink;
+    std::thread thread;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::atomic<bool> stopRequested;
+    // Set by push once the queue is half full, cleared by the writer when it wakes
+    std::atomic<bool> wakeRequested;
+    bool running;
+    int flushIntervalMs;
+    std::atomic<uint64_t> pushedSamples;
+    std::atomic<uint64_t> writtenSamples;
+    std::atomic<uint64_t> droppedSamples;
+    std::atomic<size_t> queueHighWater;
+
+    void run();
+    size_t drainBatch(std::vector<TelemetrySample>& batch);
+};
+
+#endif
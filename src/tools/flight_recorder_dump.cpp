@@ -0,0 +1,77 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "telemetry/flight_recorder.h"
+#include "telemetry/mapped_file.h"
+
+// Extracts the last N seconds from a flight recorder (black box) file as CSV
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: flight-recorder-dump <blackbox.bin> [--seconds <n>] [--output <file.csv>]" << std::endl;
+        return 1;
+    }
+
+    double seconds = 10.0;
+    const char* outputPath = nullptr;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+            if (seconds <= 0.0) {
+                std::cerr << "ERROR: --seconds must be positive" << std::endl;
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        }
+    }
+
+    MappedFile file;
+    if (!file.open(argv[1])) {
+        return 1;
+    }
+    std::vector<FlightRecord> records;
+    if (!readFlightRecords(file.getData(), file.getSize(), records)) {
+        std::cerr << "ERROR: " << argv[1] << " is not a flight recorder file" << std::endl;
+        return 1;
+    }
+    if (records.empty()) {
+        std::cerr << "No records found" << std::endl;
+        return 0;
+    }
+
+    // Walk back from the newest record to the start of the window
+    int64_t windowStart = records.back().timestampNs - (int64_t)(seconds * 1e9);
+    size_t first = records.size();
+    while (first > 0 && records[first - 1].timestampNs >= windowStart) {
+        --first;
+    }
+
+    FILE* out = outputPath ? std::fopen(outputPath, "w") : stdout;
+    if (!out) {
+        std::cerr << "ERROR: Failed to open " << outputPath << std::endl;
+        return 1;
+    }
+    std::fprintf(out, "sequence,timestamp_ns,tick,pos_x,pos_y,pos_z,rot_x,rot_y,rot_z,rot_w,vel_x,vel_y,vel_z,"
+                      "thrust_x,thrust_y,thrust_z,ring_index,frame_ms,cpu_frame_ms,flags\n");
+    for (size_t i = first; i < records.size(); ++i) {
+        const FlightRecord& r = records[i];
+        std::fprintf(out, "%llu,%lld,%llu,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%f,%d,%.3f,%.3f,%u\n",
+                     (unsigned long long)r.sequence, (long long)r.timestampNs, (unsigned long long)r.tick,
+                     r.position[0], r.position[1], r.position[2],
+                     r.orientation[0], r.orientation[1], r.orientation[2], r.orientation[3],
+                     r.velocity[0], r.velocity[1], r.velocity[2],
+                     r.thrust[0], r.thrust[1], r.thrust[2],
+                     r.ringIndex, r.frameSeconds * 1000.0f, r.cpuFrameSeconds * 1000.0f, r.flags);
+    }
+    if (out != stdout) {
+        std::fclose(out);
+    }
+
+    if (first < records.size()) {
+        std::cerr << "Extracted " << records.size() - first << " of " << records.size() << " records (sequence "
+                  << records[first].sequence << " - " << records.back().sequence << ")" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "sim/thread_pool.h"
+#include "telemetry/csv_ingest.h"
+#include "telemetry/telemetry_writer.h"
+
+// Bulk-loads legacy drone_log.csv files, optionally re-encoding them as binary logs
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: telemetry-ingest <drone_log.csv> [--threads <n>] [--to-dtl <output.dtl>]" << std::endl;
+        return 1;
+    }
+
+    unsigned threads = 0;
+    std::string dtlPath;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = (unsigned)std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--to-dtl") == 0 && i + 1 < argc) {
+            dtlPath = argv[++i];
+        }
+    }
+
+    ThreadPool pool(threads);
+    TelemetryColumns columns;
+    CsvIngestStats stats;
+    auto start = std::chrono::steady_clock::now();
+    if (!ingestTelemetryCsv(argv[1], columns, &pool, &stats)) {
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Parsed " << stats.rows << " rows (" << stats.badRows << " malformed) from " << stats.bytes
+              << " bytes in " << seconds * 1000.0 << " ms using " << pool.getThreadCount() << " threads ("
+              << (seconds > 0.0 ? stats.bytes / seconds / 1e9 : 0.0) << " GB/s)" << std::endl;
+
+    if (!dtlPath.empty()) {
+        BinaryTelemetrySink sink;
+        if (!sink.open(dtlPath)) {
+            std::cerr << "ERROR: Failed to open " << dtlPath << std::endl;
+            return 1;
+        }
+        std::vector<TelemetrySample> batch;
+        batch.reserve(4096);
+        for (size_t i = 0; i < columns.size(); ++i) {
+            batch.push_back(columns.getSample(i));
+            if (batch.size() == batch.capacity()) {
+                sink.write(batch.data(), batch.size());
+                batch.clear();
+            }
+        }
+        sink.write(batch.data(), batch.size());
+        sink.close();
+        std::cout << "Wrote " << dtlPath << std::endl;
+    }
+    return 0;
+}
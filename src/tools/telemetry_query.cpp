@@ -0,0 +1,120 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include "sim/thread_pool.h"
+#include "telemetry/telemetry_reader.h"
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: telemetry-query <log.dtl> [options]\n"
+              << "  --from <ms>          Start of the range (epoch milliseconds, default: start of log)\n"
+              << "  --to <ms>            End of the range, inclusive (default: end of log)\n"
+              << "  --columns <list>     Comma-separated groups: pos,vel,thrust (default: all)\n"
+              << "  --threads <n>        Decode threads (default: all cores)\n"
+              << "  --print              Print matching samples as CSV" << std::endl;
+}
+
+uint32_t parseColumns(const char* list) {
+    uint32_t mask = 1u << kColumnTimestamp;
+    std::string groups = list;
+    size_t start = 0;
+    while (start <= groups.size()) {
+        size_t comma = groups.find(',', start);
+        std::string group = groups.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        if (group == "pos") {
+            mask |= (1u << kColumnPosX) | (1u << kColumnPosY) | (1u << kColumnPosZ);
+        } else if (group == "vel") {
+            mask |= (1u << kColumnVelX) | (1u << kColumnVelY) | (1u << kColumnVelZ);
+        } else if (group == "thrust") {
+            mask |= (1u << kColumnThrustX) | (1u << kColumnThrustY) | (1u << kColumnThrustZ);
+        } else {
+            std::cerr << "Warning: unknown column group '" << group << "'" << std::endl;
+        }
+        if (comma == std::string::npos) break;
+        start = comma + 1;
+    }
+    return mask;
+}
+
+} // namespace
+
+// Answers time-range queries against a binary flight log
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    int64_t from = std::numeric_limits<int64_t>::min();
+    int64_t to = std::numeric_limits<int64_t>::max();
+    uint32_t columnMask = kAllTelemetryColumns;
+    unsigned threads = 0;
+    bool print = false;
+    for (int i = 2; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--from") == 0 && i + 1 < argc) {
+            from = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+            to = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--columns") == 0 && i + 1 < argc) {
+            columnMask = parseColumns(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = (unsigned)std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--print") == 0) {
+            print = true;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    auto openStart = std::chrono::steady_clock::now();
+    TelemetryReader reader;
+    if (!reader.open(argv[1])) {
+        return 1;
+    }
+    auto openEnd = std::chrono::steady_clock::now();
+
+    std::cout << "File: " << argv[1] << " (" << reader.getFileSize() << " bytes)" << std::endl;
+    std::cout << "Chunks: " << reader.getChunks().size() << (reader.wasIndexRebuilt() ? " (index rebuilt by scan)" : "")
+              << ", samples: " << reader.getSampleCount() << std::endl;
+    std::cout << "Time range: " << reader.getStartTime() << " - " << reader.getEndTime() << " ms" << std::endl;
+
+    ThreadPool pool(threads);
+    TelemetryColumns result;
+    auto queryStart = std::chrono::steady_clock::now();
+    if (!reader.query(from, to, columnMask, result, &pool)) {
+        return 1;
+    }
+    auto queryEnd = std::chrono::steady_clock::now();
+
+    size_t first, last;
+    reader.findChunks(from, to, first, last);
+    std::cout << "Matched " << result.size() << " samples from " << (last - first) << " chunks using "
+              << pool.getThreadCount() << " threads" << std::endl;
+    std::cout << "Open: " << std::chrono::duration<double, std::milli>(openEnd - openStart).count() << " ms, query: "
+              << std::chrono::duration<double, std::milli>(queryEnd - queryStart).count() << " ms" << std::endl;
+
+    if (print) {
+        static const char* const names[kTelemetryFloatColumnCount] = {
+            "pos_x", "pos_y", "pos_z", "vel_x", "vel_y", "vel_z", "thrust_x", "thrust_y", "thrust_z"
+        };
+        std::printf("timestamp");
+        for (int c = 0; c < kTelemetryFloatColumnCount; ++c) {
+            if (columnMask & (1u << (kColumnPosX + c))) std::printf(",%s", names[c]);
+        }
+        std::printf("\n");
+        for (size_t i = 0; i < result.size(); ++i) {
+            std::printf("%lld", (long long)result.timestamps[i]);
+            for (int c = 0; c < kTelemetryFloatColumnCount; ++c) {
+                if (columnMask & (1u << (kColumnPosX + c))) std::printf(",%f", result.values[c][i]);
+            }
+            std::printf("\n");
+        }
+    }
+    return 0;
+}
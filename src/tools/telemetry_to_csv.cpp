@@ -0,0 +1,66 @@
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "telemetry/telemetry_format.h"
+#include "telemetry/telemetry_writer.h"
+
+// Converts a binary .dtl flight log back to the drone_log.csv schema
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: telemetry-to-csv <input.dtl> [output.csv]" << std::endl;
+        return 1;
+    }
+    std::string inputPath = argv[1];
+    std::string outputPath;
+    if (argc > 2) {
+        outputPath = argv[2];
+    } else {
+        size_t dot = inputPath.find_last_of('.');
+        outputPath = (dot == std::string::npos ? inputPath : inputPath.substr(0, dot)) + ".csv";
+    }
+
+    std::ifstream input(inputPath, std::ios::binary);
+    if (!input.is_open()) {
+        std::cerr << "ERROR: Failed to open " << inputPath << std::endl;
+        return 1;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    std::vector<TelemetryChunkInfo> chunks;
+    if (!readTelemetryIndex(data.data(), data.size(), chunks)) {
+        if (!scanTelemetryChunks(data.data(), data.size(), chunks)) {
+            std::cerr << "ERROR: " << inputPath << " is not a telemetry log" << std::endl;
+            return 1;
+        }
+        std::cerr << "Warning: chunk index missing, recovered " << chunks.size() << " chunks by scanning" << std::endl;
+    }
+
+    CsvTelemetrySink csv;
+    if (!csv.open(outputPath)) {
+        std::cerr << "ERROR: Failed to open " << outputPath << std::endl;
+        return 1;
+    }
+
+    TelemetryColumns columns;
+    std::vector<TelemetrySample> samples;
+    size_t total = 0;
+    for (const auto& chunk : chunks) {
+        columns.clear();
+        if (!decodeTelemetryChunk(data.data(), data.size(), chunk.offset, kAllTelemetryColumns, columns)) {
+            std::cerr << "ERROR: Corrupt chunk at offset " << chunk.offset << ", stopping" << std::endl;
+            break;
+        }
+        samples.resize(columns.size());
+        for (size_t i = 0; i < columns.size(); ++i) {
+            samples[i] = columns.getSample(i);
+        }
+        csv.write(samples.data(), samples.size());
+        total += samples.size();
+    }
+    csv.close();
+
+    std::cout << "Wrote " << total << " samples from " << chunks.size() << " chunks to " << outputPath << std::endl;
+    return 0;
+}